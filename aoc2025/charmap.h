@@ -9,6 +9,7 @@
 #include <string>  // std::string
 #include <vector>  // std::vector
 
+#include "neighborhood.h"
 #include "point.h"
 
 struct charmap_t {
@@ -141,21 +142,32 @@ struct charmap_t {
 			   std::views::join;
 	}
 
-	// std::vector<point_t> _directions{{0, -1}, {1, 0}, {0, 1}, {-1, 0}};
-	std::vector<point_t> _directions{
-			{-1, -1}, { 0, -1}, { 1, -1},
-			{-1,  0},           { 1,  0},
-			{-1,  1}, { 0,  1}, { 1,  1}};  
+	/* std::views iterator of pair<point_t, char> for the neighbours of p that
+	 * are on the map. Neighborhood is von_neumann_t (4), moore_t (8) or a stencil_t. */
+	template <typename Neighborhood = moore_t>
 	auto neighbors_of(const point_t& p) const {
-		return _directions |
-			   std::views::filter([this, &p](const point_t& direction) {
-				   return this->is_valid(p + direction);
+		return Neighborhood::steps |
+			   std::views::filter([this, p](const offset_t& step) {
+				   return this->is_valid(p.x + step.dx, p.y + step.dy);
 			   }) |
-			   std::views::transform([this, &p](const point_t& direction) {
-				   return std::pair<point_t, char>(p + direction, this->get(p + direction));
+			   std::views::transform([this, p](const offset_t& step) {
+				   point_t neighbor = p + step;
+				   return std::pair<point_t, char>(neighbor, this->get(neighbor));
 			   });
 	}
 
+	/* Number of neighbours of p that are the character ch. */
+	template <typename Neighborhood = moore_t>
+	size_t count_neighbors(const point_t& p, const char ch) const {
+		size_t count = 0;
+		Neighborhood::for_each([&](const offset_t& step) {
+			if (this->is_char(p.x + step.dx, p.y + step.dy, ch)) {
+				count++;
+			}
+		});
+		return count;
+	}
+
 	// std::views iterator for all point_t with character
 	auto all_points() const {
 		return std::views::iota(0u, data.size()) |
@@ -1,46 +1,124 @@
-
 #include "chinese_remainder.h"
 #include <vector>	// std::vector
 #include <cassert>	// assert()
 
+// products of two size_t (and the Bezout coefficients of two) need 128 bits
+__extension__ typedef unsigned __int128 crt_wide_t;
+__extension__ typedef __int128 crt_signed_t;
+
+namespace {
+
+size_t mul_mod(size_t a, size_t b, size_t m) {
+	return static_cast<size_t>(static_cast<crt_wide_t>(a) * b % m);
+}
+
+}  // namespace
+
 // Returns modulo inverse of a
 // with respect to m using
 // extended Euclid Algorithm.
-// Refer below post for details:
-// https://www.geeksforgeeks.org/
-// multiplicative-inverse-under-modulo-m/
-size_t mod_inverse(size_t p_a, size_t p_m) {
-	long m = (long)p_m;
-	long a = (long)p_a;
-
-	long x0 = 0;
-	long x1 = 1;
-	long m0 = (long)p_m;
-	long t;
-	long q;
-
+size_t mod_inverse(size_t a, size_t m) {
 	if (m == 1) {
 		return 0;
 	}
 
-	// Apply extended Euclid Algorithm
-	while (a > 1) {
-		q = (long)a / m;	// q is quotient
-		t = m;
+	crt_signed_t r0 = a % m;
+	crt_signed_t r1 = m;
+	crt_signed_t x0 = 1;
+	crt_signed_t x1 = 0;
+	while (r1 != 0) {
+		crt_signed_t q = r0 / r1;
+
+		crt_signed_t t = r1;
+		r1 = r0 - q * r1;
+		r0 = t;
+
+		t = x1;
+		x1 = x0 - q * x1;
+		x0 = t;
+	}
+	assert(r0 == 1);
+
+	// make x0 positive
+	if (x0 < 0) {
+		x0 += m;
+	}
+
+	return static_cast<size_t>(x0);
+}
+
+crt_solver_t::crt_solver_t(std::span<const size_t> moduli) {
+	_steps.reserve(moduli.size());
+	for (size_t modulus : moduli) {
+		assert(modulus > 0);
+
+		const size_t g = std::gcd(_modulus, modulus);
+		const size_t step = modulus / g;
+		_steps.push_back({modulus, _modulus, g, step, mod_inverse(_modulus / g % step, step)});
+
+		const crt_wide_t next = static_cast<crt_wide_t>(_modulus) * step;
+		if (next > SIZE_MAX) {
+			_fits = false;	// the steps after this are never used
+			continue;
+		}
+		_modulus = static_cast<size_t>(next);
+	}
+}
+
+std::optional<size_t> crt_solver_t::solve(std::span<const size_t> remainders) const {
+	assert(remainders.size() == _steps.size());
+	if (!_fits) {
+		return std::nullopt;
+	}
+
+	// x = r (mod before); find t with r + before * t = remainder (mod modulus)
+	size_t r = 0;
+	for (size_t i = 0; i < _steps.size(); i++) {
+		const step_t& s = _steps[i];
+		const size_t diff = (remainders[i] % s.modulus + s.modulus - r % s.modulus) % s.modulus;
+		if (diff % s.gcd != 0) {
+			return std::nullopt;  // disagrees with the earlier congruences
+		}
+
+		// before * t < lcm, and r < before, so r stays below the lcm
+		r += s.before * mul_mod(diff / s.gcd, s.inverse, s.step);
+	}
+
+	return r;
+}
+
+std::vector<std::optional<size_t>> crt_solver_t::solve_all(const std::vector<std::vector<size_t>>& systems) const {
+	std::vector<std::optional<size_t>> solutions;
+	solutions.reserve(systems.size());
+	for (const auto& remainders : systems) {
+		solutions.push_back(solve(remainders));
+	}
+
+	return solutions;
+}
 
-		// m is remainder now, process same as euclid's algo
-		m = a % m, a = t;
-		t = x0;
-		x0 = x1 - q * x0;
-		x1 = t;
+std::optional<congruence_t> solve_congruences(std::span<const congruence_t> system) {
+	std::vector<size_t> moduli;
+	std::vector<size_t> remainders;
+	moduli.reserve(system.size());
+	remainders.reserve(system.size());
+	for (const congruence_t& c : system) {
+		moduli.push_back(c.modulus);
+		remainders.push_back(c.remainder);
 	}
 
-	// make x1 positive
-	if (x1 < 0) {
-		x1 += m0;
+	crt_solver_t crt(moduli);
+	std::optional<size_t> x = crt.solve(remainders);
+	if (!x) {
+		return std::nullopt;
 	}
 
-	return (size_t)x1;
+	return congruence_t{*x, crt.modulus()};
+}
+
+std::optional<congruence_t> merge_congruences(congruence_t a, congruence_t b) {
+	const congruence_t system[] = {a, b};
+	return solve_congruences(system);
 }
 
 // Returns the smallest number x such that:
@@ -48,22 +126,9 @@ size_t mod_inverse(size_t p_a, size_t p_m) {
 // x % num[1] = rem[1],
 // ..................
 // x % num[k-2] = rem[k-1]
-// Assumption: Numbers in num[] are pairwise co-prime (gcd for every pair is 1)
-size_t chinese_remainder(std::vector<size_t> remainders, std::vector<size_t> numbers) {
+// The numbers need not be co-prime; nullopt if the remainders disagree.
+std::optional<size_t> chinese_remainder(std::vector<size_t> remainders, std::vector<size_t> numbers) {
 	assert(numbers.size() == remainders.size());
 
-	// Compute product of all numbers
-	size_t prod = 1;
-	for (size_t n : numbers) {
-		prod *= n;
-	}
-
-	// Initialize result
-	size_t result = 0;
-	for (size_t i = 0; i < numbers.size(); i++) {
-		size_t pp = prod / numbers[i];
-		result += remainders[i] * mod_inverse(pp, numbers[i]) * pp;
-	}
-
-	return result % prod;
+	return crt_solver_t(numbers).solve(remainders);
 }
@@ -1,8 +1,10 @@
-
 #if !defined(CHINESE_REMAINDER_H)
 #define CHINESE_REMAINDER_H
 
+#include <initializer_list>
 #include <numeric>	//	gcd() and lcm()
+#include <optional>
+#include <span>
 #include <vector>	 // std::vector
 #include <cstdint>
 
@@ -25,6 +27,64 @@ T lcm(const std::vector<T>& vec) {
 	return x;
 }
 
-extern size_t chinese_remainder(std::vector<size_t> numbers, std::vector<size_t> remainders);
+/* x = remainder (mod modulus) */
+struct congruence_t {
+	size_t remainder = 0;
+	size_t modulus = 1;
+};
+
+/* Solves x = remainders[i] (mod moduli[i]) for many sets of remainders over
+ * the same moduli. The moduli need not be coprime: they are merged one at a
+ * time into their lcm, and everything that depends only on the moduli (gcds,
+ * inverses) is worked out once here, so each solve() is a few multiplies
+ * and divides per modulus. Products are taken in 128 bits, so any moduli
+ * whose lcm fits in size_t work.
+ *
+ *	crt_solver_t crt({7, 13, 59});
+ *	std::optional<size_t> x = crt.solve({0, 12, 55});
+ */
+class crt_solver_t {
+   public:
+	explicit crt_solver_t(std::span<const size_t> moduli);
+	crt_solver_t(std::initializer_list<size_t> moduli) : crt_solver_t(std::span<const size_t>(moduli)) {}
+
+	/* The smallest x >= 0 meeting every congruence; nullopt if they
+	 * contradict each other, or the lcm of the moduli does not fit. */
+	std::optional<size_t> solve(std::span<const size_t> remainders) const;
+	std::optional<size_t> solve(std::initializer_list<size_t> remainders) const {
+		return solve(std::span<const size_t>(remainders));
+	}
+
+	/* solve() for each system of remainders in turn */
+	std::vector<std::optional<size_t>> solve_all(const std::vector<std::vector<size_t>>& systems) const;
+
+	/* lcm of the moduli; solutions repeat this often. 0 if it does not fit. */
+	size_t modulus() const { return _fits ? _modulus : 0; }
+
+   private:
+	// merging (r mod before) with (remainder mod modulus) into mod before * step
+	struct step_t {
+		size_t modulus;
+		size_t before;	 // lcm of the earlier moduli
+		size_t gcd;		 // of before and modulus
+		size_t step;	 // modulus / gcd
+		size_t inverse;	 // of before / gcd, mod step
+	};
+
+	std::vector<step_t> _steps = {};
+	size_t _modulus = 1;
+	bool _fits = true;
+};
+
+/* The congruence every x meeting all of system's does: the smallest such x
+ * mod the lcm of the moduli. nullopt if there is none (or the lcm overflows). */
+std::optional<congruence_t> solve_congruences(std::span<const congruence_t> system);
+std::optional<congruence_t> merge_congruences(congruence_t a, congruence_t b);
+
+/* Inverse of a modulo m; a and m coprime. */
+size_t mod_inverse(size_t a, size_t m);
+
+/* Smallest x with x % numbers[i] == remainders[i]; nullopt if there is none */
+extern std::optional<size_t> chinese_remainder(std::vector<size_t> remainders, std::vector<size_t> numbers);
 
-#endif
\ No newline at end of file
+#endif
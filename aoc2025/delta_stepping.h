@@ -0,0 +1,226 @@
+#if !defined(DELTA_STEPPING_H)
+#define DELTA_STEPPING_H
+
+#include <algorithm>  // min, max
+#include <atomic>
+#include <cassert>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include <utility>  // std::forward
+#include <vector>
+
+#include "charmap.h"
+#include "graph.h"
+#include "neighborhood.h"
+#include "parallel.h"
+#include "shortest_path.h"	// unreached_cost, search_stats_t
+
+/* Parallel single source shortest paths by delta-stepping.
+ *
+ * Tentative distances are kept in buckets delta wide. Every node in the
+ * lowest bucket is relaxed at once, spread over the thread pool, and each
+ * improvement goes into the improving thread's own bucket (no locks, the
+ * distance itself is lowered with a compare and swap). When a round ends the
+ * threads' lowest buckets are joined into the next frontier. A node can be
+ * relaxed more than once, but never below the bucket being worked on, so the
+ * distances come out the same as Dijkstra's.
+ *
+ * delta trades the two costs: 1 is Dijkstra by buckets (one round per
+ * distance, little wasted work); larger relaxes more at once and redoes some
+ * of it. Somewhere around the largest edge weight is usually best.
+ *
+ * Pass stats to see the work done: nodes relaxed (expanded), improvements
+ * (pushed) and, built with SEARCH_COUNTERS, frontier entries (pops), ones
+ * already settled (stale), edges, the largest frontier and memory.
+ *
+ *	auto dist = delta_stepping(graph, source, [&](node_t u, node_t v) { return w(u, v); }, 32);
+ *	auto field = delta_stepping(map, start, 8);	 // field[y * size_x + x]
+ */
+
+/* Distances from sources to every node 0..nodes-1, unreached_cost where
+ * there is no path. edges(u, relax) calls relax(v, weight) for every edge out
+ * of u, and is called from several threads at once. */
+template <typename Edges>
+std::vector<size_t> delta_stepping(size_t nodes, std::span<const size_t> sources, Edges&& edges, size_t delta,
+								   thread_pool_t& pool = thread_pool_t::shared(), search_stats_t* stats = nullptr) {
+	assert(delta > 0);
+	using bins_t = std::vector<std::vector<size_t>>;
+	auto started = std::chrono::steady_clock::now();
+
+	std::vector<size_t> dist(nodes, unreached_cost);
+	std::vector<bins_t> local(pool.size());	 // each thread's buckets
+	std::vector<search_stats_t> counted(pool.size());	// each thread's share of stats
+
+	std::vector<size_t> frontier;
+	for (size_t s : sources) {
+		if (dist[s] != 0) {
+			dist[s] = 0;
+			frontier.push_back(s);
+			counted[0].pushed++;
+		}
+	}
+
+	// below this many nodes a round is cheaper than waking the pool
+	constexpr size_t serial_frontier = 256;
+
+	size_t bin = 0;
+	while (!frontier.empty()) {
+		const size_t floor = bin * delta;
+		const size_t grain = std::max<size_t>(64, frontier.size() / (pool.size() * 8));
+		std::atomic<size_t> next = 0;
+
+		auto round = [&](size_t thread_index) {
+			bins_t& bins = local[thread_index];
+			search_stats_t share;	// on the stack, so threads don't share a cache line
+			auto relax = [&](size_t v, size_t d) {
+				share.count_relaxed();
+				std::atomic_ref<size_t> slot(dist[v]);
+				size_t old = slot.load(std::memory_order_relaxed);
+				while (d < old) {
+					if (slot.compare_exchange_weak(old, d, std::memory_order_relaxed)) {
+						const size_t b = d / delta;
+						if (b >= bins.size()) {
+							bins.resize(b + 1);
+						}
+						bins[b].push_back(v);
+						share.pushed++;
+						return;
+					}
+				}
+			};
+
+			for (size_t begin = next.fetch_add(grain); begin < frontier.size(); begin = next.fetch_add(grain)) {
+				const size_t end = std::min(begin + grain, frontier.size());
+				for (size_t i = begin; i < end; i++) {
+					const size_t u = frontier[i];
+					const size_t du = std::atomic_ref<size_t>(dist[u]).load(std::memory_order_relaxed);
+					if (du < floor) {
+						share.count_stale();
+						continue;  // settled in an earlier bucket
+					}
+					share.expanded++;
+
+					edges(u, [&](size_t v, size_t weight) { relax(v, du + weight); });
+				}
+			}
+			counted[thread_index].merge(share);
+		};
+
+		counted[0].count_frontier(frontier.size());
+
+		if (frontier.size() < serial_frontier) {
+			round(0);
+		} else {
+			pool.run_on_all(round);
+		}
+
+		// every improvement was to at least floor, so nothing is below bin
+		size_t lowest = SIZE_MAX;
+		for (const bins_t& bins : local) {
+			for (size_t b = bin; b < bins.size() && b < lowest; b++) {
+				if (!bins[b].empty()) {
+					lowest = b;
+				}
+			}
+		}
+
+		frontier.clear();
+		if (lowest == SIZE_MAX) {
+			break;
+		}
+
+		for (bins_t& bins : local) {
+			if (lowest < bins.size()) {
+				frontier.insert(frontier.end(), bins[lowest].begin(), bins[lowest].end());
+				bins[lowest].clear();
+			}
+		}
+		bin = lowest;
+	}
+
+	if (stats != nullptr) {
+		*stats = {};
+		for (const search_stats_t& share : counted) {
+			stats->merge(share);
+		}
+
+		size_t bytes = (dist.capacity() + frontier.capacity()) * sizeof(size_t);
+		for (const bins_t& bins : local) {
+			bytes += bins.capacity() * sizeof(bins[0]);
+			for (const auto& b : bins) {
+				bytes += b.capacity() * sizeof(size_t);
+			}
+		}
+		stats->count_bytes(bytes);
+		stats->elapsed_ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - started).count();
+	}
+
+	return dist;
+}
+
+template <typename Edges>
+std::vector<size_t> delta_stepping(size_t nodes, size_t source, Edges&& edges, size_t delta,
+								   thread_pool_t& pool = thread_pool_t::shared(), search_stats_t* stats = nullptr) {
+	return delta_stepping(nodes, std::span<const size_t>(&source, 1), std::forward<Edges>(edges), delta, pool, stats);
+}
+
+/* Over graph_t, where weight(u, v) is what the edge u -> v costs. */
+template <typename Weight>
+std::vector<size_t> delta_stepping(const graph_t& graph, node_t source, Weight&& weight, size_t delta,
+								   thread_pool_t& pool = thread_pool_t::shared(), search_stats_t* stats = nullptr) {
+	auto edges = [&](size_t u, auto&& relax) {
+		for (node_t v : graph.neighbors(static_cast<node_t>(u))) {
+			relax(v, static_cast<size_t>(weight(static_cast<node_t>(u), v)));
+		}
+	};
+	return delta_stepping(graph.size(), size_t{source}, edges, delta, pool, stats);
+}
+
+/* Distance field over a map of digits; entering a tile costs its digit and
+ * anything that is not a digit is a wall. Indexed y * size_x + x. */
+template <typename Neighborhood = von_neumann_t>
+std::vector<size_t> delta_stepping(const charmap_t& map, const point_t& source, size_t delta,
+								   thread_pool_t& pool = thread_pool_t::shared(), search_stats_t* stats = nullptr) {
+	const auto width = static_cast<size_t>(map.size_x);
+	const auto height = static_cast<size_t>(map.size_y);
+	constexpr uint8_t wall = UINT8_MAX;
+
+	// one byte per tile, so each relaxation reads the cost straight from an array
+	std::vector<uint8_t> cost(width * height, wall);
+	for (size_t y = 0; y < height; y++) {
+		for (size_t x = 0; x < width; x++) {
+			const char c = map.data[y][x];
+			if ('0' <= c && c <= '9') {
+				cost[y * width + x] = static_cast<uint8_t>(c - '0');
+			}
+		}
+	}
+
+	auto edges = [&](size_t u, auto&& relax) {
+		const auto x = static_cast<dimension_t>(u % width);
+		const auto y = static_cast<dimension_t>(u / width);
+		Neighborhood::for_each([&](const offset_t& step) {
+			const dimension_t nx = x + step.dx;
+			const dimension_t ny = y + step.dy;
+			if (nx < 0 || ny < 0 || nx >= map.size_x || ny >= map.size_y) {
+				return;
+			}
+
+			const size_t v = static_cast<size_t>(ny) * width + static_cast<size_t>(nx);
+			if (cost[v] != wall) {
+				relax(v, cost[v]);
+			}
+		});
+	};
+
+	if (!map.is_valid(source)) {
+		return std::vector<size_t>(width * height, unreached_cost);
+	}
+
+	const size_t s = static_cast<size_t>(source.y) * width + static_cast<size_t>(source.x);
+	return delta_stepping(width * height, s, edges, delta, pool, stats);
+}
+
+#endif
@@ -1,29 +1,931 @@
-
 #if !defined(DIJKSTRA_H)
 #define DIJKSTRA_H
 
+#include <limits.h>
+
+#include <algorithm>  // fill, min
+#include <cassert>
+#include <chrono>
+#include <cstdlib>	// abs
+#include <cstdint>
+#include <limits>
 #include <map>
+#include <memory>  // unique_ptr
+#include <queue>
+#include <set>
+#include <span>
+#include <type_traits>
+#include <utility>	// std::pair
 #include <vector>
 
 #include "charmap.h"
+#include "neighborhood.h"
 #include "point.h"
+#include "priority_queue.h"
+#include "shortest_path.h"
 #include "vector.h"
 
 // dijkstra types, code below
 using dist_t = std::map<vector_t, size_t>;
 using pred_t = std::map<vector_t, std::vector<vector_t>>;
 
-// Returns, min_cost, dist[], pred[]
+// the cost to go from current to neighbor
+using cost_fn_t = size_t (*)(const size_t cost,
+							 const vector_t& current, const vector_t& neighbor,
+							 const charmap_t& map);
+
+// used to keep Q in cost (reverse) order. this one works :-)
+class compare_cost {
+   public:
+	bool operator()(vector_t& a, vector_t& b) {
+		return b.p.z < a.p.z;
+	}
+};
+
+// The cost to go from current to neighbor; the digit on the neighbor's tile
+size_t default_cost(const size_t cost,
+					const vector_t& current, const vector_t& neighbor,
+					const charmap_t& map);
+
+/* Estimates of the cost from p to end for grid_dijkstra_t::astar(); they
+ * must never be over (admissible) and not drop by more than a step's cost
+ * per step (consistent). min_weight is the least a step can cost. */
+struct manhattan_heuristic_t {
+	size_t min_weight = 1;
+
+	size_t operator()(const point_t& p, const point_t& end) const {
+		return min_weight * static_cast<size_t>(manhattan_distance(p, end));
+	}
+};
+
+// for moore_t, where a diagonal step covers two in Manhattan distance
+struct chebyshev_heuristic_t {
+	size_t min_weight = 1;
+
+	size_t operator()(const point_t& p, const point_t& end) const {
+		return min_weight * static_cast<size_t>(std::max(std::abs(p.x - end.x), std::abs(p.y - end.y)));
+	}
+};
+
+// no estimate at all; astar() with this is dijkstra
+struct zero_heuristic_t {
+	size_t operator()(const point_t&, const point_t&) const { return 0; }
+};
+
+/* Dijkstra over the map in flat arrays. A state is (position, the step we
+ * moved by to get there) and lives at (y * W + x) * slots + heading, where
+ * heading is the step's index in Neighborhood and slot Neighborhood::size
+ * is for a start without one. All predecessors of a state are on the tile
+ * one step back, so they are kept as a bitmask of their headings.
+ *
+ *	grid_dijkstra_t<> search(map);
+ *	size_t cost = search.run(start, end);
+ *	print("{} states, {:.1f}ns each\n", search.stats.expanded, search.stats.ns_per_node());
+ *
+ * astar() is the same search ordered by cost plus an estimate of the cost
+ * left; it finds the same cost and expands far fewer states on the way.
+ * bidirectional() searches from both ends and stops where they meet.
+ *
+ * Keep one around for many queries on the same map. Every state is stamped
+ * with the search that last reached it, and anything stamped by an earlier
+ * search reads as unreached, so a new search starts without clearing (or
+ * allocating) anything; the cost of a query is only what it explores.
+ * run() also takes several starts, run_to_targets() finds the nearest of
+ * several sets of tiles in one search, and run_field() with export_field()
+ * gives the cost to every tile.
+ *
+ * Costs are kept as Dist, 32 bits unless asked for more, so a state takes
+ * 8 bytes: a 2000 x 2000 map with 5 slots a tile is 160MB. Use
+ * grid_dijkstra_t<Neighborhood, size_t> for paths costing 2^32 or more.
+ */
+template <typename Neighborhood = von_neumann_t, typename Dist = uint32_t>
+class grid_dijkstra_t {
+   public:
+	using index_t = size_t;
+	using mask_t = uint16_t;
+
+	static constexpr size_t slots = Neighborhood::size + 1;
+	static constexpr size_t no_heading = Neighborhood::size;
+	static constexpr size_t unreached = SIZE_MAX;
+	static_assert(slots < 16, "predecessor mask is 16 bits, one for starts");
+	static_assert(std::is_unsigned_v<Dist>, "costs are unsigned");
+
+	search_stats_t stats = {};
+
+	explicit grid_dijkstra_t(const charmap_t& map)
+		: _map(map),
+		  _width(static_cast<size_t>(map.size_x)),
+		  _height(static_cast<size_t>(map.size_y)),
+		  _states(_width * _height * slots) {
+	}
+
+	/* Cost from start to the first state on end popped, unreached if there
+	 * is none. dist and pred are left for what was explored up to then.
+	 * max_weight bounds what one step can cost, 0 if unknown; with it
+	 * automatic runs on a dial_queue_t, without on a radix_heap_t. */
+	size_t run(const vector_t& start, const point_t& end, cost_fn_t cost_fn = nullptr,
+			   size_t max_weight = 0, queue_kind_t queue = queue_kind_t::automatic) {
+		return run(std::span<const vector_t>(&start, 1), end, cost_fn, max_weight, queue);
+	}
+
+	// from whichever of starts is cheapest; all start at cost 0
+	size_t run(std::span<const vector_t> starts, const point_t& end, cost_fn_t cost_fn = nullptr,
+			   size_t max_weight = 0, queue_kind_t queue = queue_kind_t::automatic) {
+		return with_queue(queue, max_weight, [&](auto& Q) {
+			return search_to(Q, starts, end, cost_fn, zero_heuristic_t{});
+		});
+	}
+
+	/* As run(), visiting states in order of cost plus heuristic(p, end).
+	 * Cost and dist are exact for everything on a cheapest path found; the
+	 * preds lead back along at least one of them. */
+	template <typename Heuristic = manhattan_heuristic_t>
+	size_t astar(const vector_t& start, const point_t& end, Heuristic heuristic = {}, cost_fn_t cost_fn = nullptr,
+				 size_t max_weight = 0, queue_kind_t queue = queue_kind_t::automatic) {
+		// cost plus estimate rises by at most a step and the estimate's drop, 2 * max_weight
+		return with_queue(queue, 2 * max_weight, [&](auto& Q) {
+			return search_to(Q, std::span<const vector_t>(&start, 1), end, cost_fn, heuristic);
+		});
+	}
+
+	/* As run(), searching forward from start and backward from end at once
+	 * until the two can no longer improve on the best meeting found; each
+	 * covers about half the distance. cost_fn must add the step's weight to
+	 * the cost it is given, as default_cost does. Afterwards dist and pred
+	 * hold the forward search plus a cheapest path on from where they met,
+	 * so dijkstra_path() works from end as usual. */
+	size_t bidirectional(const vector_t& start, const point_t& end, cost_fn_t cost_fn = nullptr,
+						 size_t max_weight = 0, queue_kind_t queue = queue_kind_t::automatic) {
+		return with_queue(queue, max_weight, [&](auto& Q) {
+			return meet_in_middle(Q, start, end, cost_fn);
+		});
+	}
+
+	/* Cost from starts to the nearest tile of each set in targets, in one
+	 * search that stops once every set has been reached; unreached for a
+	 * set that cannot be. */
+	std::vector<size_t> run_to_targets(std::span<const vector_t> starts, const std::vector<std::vector<point_t>>& targets,
+									   cost_fn_t cost_fn = nullptr, size_t max_weight = 0,
+									   queue_kind_t queue = queue_kind_t::automatic) {
+		std::vector<size_t> costs(targets.size(), unreached);
+
+		// (tile, set) sorted by tile; a tile is looked up only if stamped as a target
+		if (_target_stamp.size() != _width * _height) {
+			_target_stamp.assign(_width * _height, 0);
+			_target_generation = 0;
+		}
+		if (++_target_generation == 0) {
+			std::fill(_target_stamp.begin(), _target_stamp.end(), 0);
+			_target_generation = 1;
+		}
+
+		_targets.clear();
+		size_t remaining = 0;
+		for (size_t k = 0; k < targets.size(); k++) {
+			bool any = false;
+			for (const point_t& p : targets[k]) {
+				if (_map.is_valid(p)) {
+					const size_t tile = static_cast<size_t>(p.y) * _width + static_cast<size_t>(p.x);
+					_targets.push_back({tile, k});
+					_target_stamp[tile] = _target_generation;
+					any = true;
+				}
+			}
+			remaining += any ? 1u : 0u;
+		}
+		std::sort(_targets.begin(), _targets.end());
+
+		if (remaining > 0) {
+			with_queue(queue, max_weight, [&](auto& Q) {
+				search(Q, starts, point_t(0, 0), cost_fn, zero_heuristic_t{}, [&](index_t u, const point_t&, size_t cost) {
+					const size_t tile = u / slots;
+					if (_target_stamp[tile] != _target_generation) {
+						return false;
+					}
+
+					auto it = std::lower_bound(_targets.begin(), _targets.end(), std::pair<size_t, size_t>{tile, 0});
+					for (; it != _targets.end() && it->first == tile; ++it) {
+						if (costs[it->second] == unreached) {
+							costs[it->second] = cost;
+							remaining--;
+						}
+					}
+					return remaining == 0;
+				});
+				return size_t{0};
+			});
+		}
+		return costs;
+	}
+
+	/* Everything reachable from starts; afterwards distance() and
+	 * export_field() cover the whole map. */
+	void run_field(std::span<const vector_t> starts, cost_fn_t cost_fn = nullptr, size_t max_weight = 0,
+				   queue_kind_t queue = queue_kind_t::automatic) {
+		with_queue(queue, max_weight, [&](auto& Q) {
+			search(Q, starts, point_t(0, 0), cost_fn, zero_heuristic_t{}, [](index_t, const point_t&, size_t) {
+				return false;
+			});
+			return size_t{0};
+		});
+	}
+
+	// the cost to each tile from the last search, y * size_x + x; unreached where not reached
+	void export_field(std::vector<size_t>& field) const {
+		field.assign(_width * _height, unreached);
+		for (size_t tile = 0; tile < field.size(); tile++) {
+			for (size_t heading = 0; heading < slots; heading++) {
+				field[tile] = std::min(field[tile], dist_of(tile * slots + heading));
+			}
+		}
+	}
+
+	size_t heading_of(const point_t& dir) const {
+		return Neighborhood::index_of(dir);
+	}
+
+	index_t index_of(const point_t& p, size_t heading) const {
+		return (static_cast<size_t>(p.y) * _width + static_cast<size_t>(p.x)) * slots + heading;
+	}
+
+	vector_t state_of(index_t i) const {
+		size_t tile = i / slots;
+		size_t heading = i % slots;
+		point_t p(tile % _width, tile / _width);
+		return {p, heading == no_heading ? _start_dir : point_t(Neighborhood::steps[heading])};
+	}
+
+	size_t distance(index_t i) const { return dist_of(i); }
+
+	size_t distance(const vector_t& v) const {
+		return _map.is_valid(v.p) ? dist_of(index_of(v.p, heading_of(v.dir))) : unreached;
+	}
+
+	// cheapest over all headings into p
+	size_t distance(const point_t& p) const {
+		size_t best = unreached;
+		if (_map.is_valid(p)) {
+			for (size_t heading = 0; heading < slots; heading++) {
+				best = std::min(best, dist_of(index_of(p, heading)));
+			}
+		}
+		return best;
+	}
+
+	// call fn(pred_index) for each predecessor on a cheapest path to state i
+	template <typename F>
+	void for_each_pred(index_t i, F&& fn) const {
+		size_t heading = i % slots;
+		const mask_t pred = pred_of(i);
+		if (heading == no_heading || pred == 0) {
+			return;
+		}
+
+		size_t tile = i / slots;
+		const offset_t step = Neighborhood::steps[heading];
+		point_t back(static_cast<dimension_t>(tile % _width) - step.dx, static_cast<dimension_t>(tile / _width) - step.dy);
+		for (size_t h = 0; h < slots; h++) {
+			if (pred & (1u << h)) {
+				fn(index_of(back, h));
+			}
+		}
+	}
+
+	// the same results as the map based dijkstra() returns
+	void export_maps(dist_t& dist, pred_t& pred) const {
+		for (index_t i = 0; i < _states.size(); i++) {
+			if (dist_of(i) == unreached) {
+				continue;
+			}
+
+			vector_t v = state_of(i);
+			dist[v] = _states[i].dist;
+			for_each_pred(i, [&](index_t j) {
+				pred[v].push_back(state_of(j));
+			});
+		}
+	}
+
+	/* The shortest path DAG, walked back from the cheapest states on end
+	 * through the pred masks. Complete after run() (with steps that cost more
+	 * than 0); astar() and bidirectional() keep one path, not all of them.
+	 * Each query touches only the states on the DAG and clears up after
+	 * itself, with no allocation once the scratch arrays are sized. */
+
+	// call fn(tile) once for each tile on any cheapest path to end; returns how many
+	template <typename F>
+	size_t for_each_path_tile(const point_t& end, F&& fn) {
+		size_t tiles = 0;
+		walk_back(end, [&](index_t i) {
+			// the tile's first slot marks the tile
+			uint8_t& tile_mark = _mark[i - i % slots];
+			if (!(tile_mark & tile_seen)) {
+				tile_mark |= tile_seen;
+				tiles++;
+				fn(state_of(i).p);
+			}
+		}, [](index_t) {});
+		return tiles;
+	}
+
+	size_t count_path_tiles(const point_t& end) {
+		return for_each_path_tile(end, [](const point_t&) {});
+	}
+
+	/* Number of distinct cheapest paths to end (mod 2^64); paths around
+	 * zero cost loops are not counted. */
+	size_t count_paths(const point_t& end) {
+		if (!_paths) {
+			// only ever read where the walk has written it, so left uninitialized
+			_paths = std::make_unique_for_overwrite<size_t[]>(_states.size());
+		}
+
+		size_t paths = 0;
+		walk_back(end, [](index_t) {}, [&](index_t i) {
+			// every pred is finished before i is, except one that is still open on a loop
+			size_t count = (pred_of(i) & start_bit) ? 1 : 0;
+			for_each_pred(i, [&](index_t j) {
+				if (_mark[j] & state_done) {
+					count += _paths[j];
+				}
+			});
+			_paths[i] = count;
+		});
+
+		const size_t best = distance(end);
+		if (best != unreached) {
+			for (size_t heading = 0; heading < slots; heading++) {
+				const index_t e = index_of(end, heading);
+				if (dist_of(e) == best) {
+					paths += _paths[e];
+				}
+			}
+		}
+		return paths;
+	}
+
+   private:
+	// marks a start in its pred mask, above every heading's bit
+	static constexpr mask_t start_bit = 1u << 15;
+
+	const charmap_t& _map;
+	size_t _width;
+	size_t _height;
+	point_t _start_dir = {0, 0};
+
+	// dist and pred hold only while stamp == _generation; together so a
+	// relaxation touches one cache line
+	using stamp_t = uint16_t;
+	struct slot_t {
+		Dist dist = 0;
+		stamp_t stamp = 0;
+		mask_t pred = 0;
+	};
+	std::vector<slot_t> _states;
+	stamp_t _generation = 0;
+
+	// the most a stored cost can be
+	static constexpr size_t dist_limit = std::numeric_limits<Dist>::max() - 1;
+
+	// run_to_targets(); tiles stamped _target_generation are in _targets
+	std::vector<uint32_t> _target_stamp = {};
+	uint32_t _target_generation = 0;
+	std::vector<std::pair<size_t, size_t>> _targets = {};
+
+	// DAG queries; marks per state and the depth first walk, cleared after each
+	static constexpr uint8_t state_seen = 1;
+	static constexpr uint8_t state_done = 2;
+	static constexpr uint8_t tile_seen = 4;
+	std::vector<uint8_t> _mark = {};
+	std::unique_ptr<size_t[]> _paths = nullptr;
+	std::vector<index_t> _stack = {};
+	std::vector<index_t> _trail = {};
+
+	// bidirectional(); cost from a state to end and heading of the next state
+	// toward end, holding while _back_stamp[i] == _generation
+	std::vector<Dist> _dist_back = {};
+	std::vector<uint8_t> _next_back = {};
+	std::vector<stamp_t> _back_stamp = {};
+
+	size_t dist_of(index_t i) const {
+		return _states[i].stamp == _generation ? _states[i].dist : unreached;
+	}
+
+	mask_t pred_of(index_t i) const {
+		return _states[i].stamp == _generation ? _states[i].pred : 0;
+	}
+
+	void reach(index_t i, size_t cost, mask_t pred) {
+		assert(cost <= dist_limit);	 // too costly for Dist; use a wider one
+		_states[i] = {static_cast<Dist>(cost), _generation, pred};
+	}
+
+	size_t dist_back_of(index_t i) const {
+		return _back_stamp[i] == _generation ? _dist_back[i] : unreached;
+	}
+
+	// a new search; everything reached before reads as unreached
+	void begin_search(const vector_t& start) {
+		if (++_generation == 0) {
+			// once every 65,535 searches
+			for (slot_t& state : _states) {
+				state.stamp = 0;
+			}
+			std::fill(_back_stamp.begin(), _back_stamp.end(), 0);
+			_generation = 1;
+		}
+		stats = {};
+		_start_dir = start.dir;
+	}
+
+	// memory held by the arrays kept between searches
+	size_t bytes() const {
+		return _states.capacity() * sizeof(slot_t)
+			 + _dist_back.capacity() * sizeof(Dist) + _next_back.capacity() + _back_stamp.capacity() * sizeof(stamp_t)
+			 + _target_stamp.capacity() * sizeof(uint32_t) + _targets.capacity() * sizeof(_targets[0])
+			 + _mark.capacity() + (_paths ? _states.size() * sizeof(size_t) : 0);
+	}
+
+	/* Depth first back through the preds from the cheapest states on end;
+	 * enter(i) on the way in, leave(i) once all of i's preds have been left.
+	 * Each state is entered and left once. */
+	template <typename Enter, typename Leave>
+	void walk_back(const point_t& end, Enter&& enter, Leave&& leave) {
+		const size_t best = distance(end);
+		if (best == unreached) {
+			return;
+		}
+		if (_mark.size() != _states.size()) {
+			_mark.assign(_states.size(), 0);
+		}
+
+		for (size_t heading = 0; heading < slots; heading++) {
+			const index_t e = index_of(end, heading);
+			if (dist_of(e) == best) {
+				_stack.push_back(e);
+			}
+		}
+
+		while (!_stack.empty()) {
+			const index_t i = _stack.back();
+			if (!(_mark[i] & state_seen)) {
+				_mark[i] |= state_seen;
+				_trail.push_back(i);
+				enter(i);
+				for_each_pred(i, [&](index_t j) {
+					if (!(_mark[j] & state_seen)) {
+						_stack.push_back(j);
+					}
+				});
+				continue;
+			}
+
+			_stack.pop_back();
+			if (!(_mark[i] & state_done)) {
+				leave(i);
+				_mark[i] |= state_done;
+			}
+		}
+
+		for (index_t i : _trail) {
+			_mark[i] = 0;
+			_mark[i - i % slots] = 0;
+		}
+		_trail.clear();
+	}
+
+	// call fn(Q) with an empty queue of the kind asked for; automatic as in run()
+	template <typename F>
+	size_t with_queue(queue_kind_t queue, size_t max_step, F&& fn) {
+		if (queue == queue_kind_t::automatic) {
+			queue = (0 < max_step && max_step <= dial_queue_limit) ? queue_kind_t::dial : queue_kind_t::radix;
+		}
+
+		switch (queue) {
+			case queue_kind_t::dial: {
+				assert(max_step > 0);
+				dial_queue_t<index_t> Q(max_step);
+				return fn(Q);
+			}
+			case queue_kind_t::radix: {
+				radix_heap_t<index_t> Q;
+				return fn(Q);
+			}
+			default: {
+				binary_queue_t<index_t> Q;
+				return fn(Q);
+			}
+		}
+	}
+
+	// search() until the first state on end, returning its cost
+	template <typename Queue, typename Heuristic>
+	size_t search_to(Queue& Q, std::span<const vector_t> starts, const point_t& end, cost_fn_t cost_fn,
+					 const Heuristic& heuristic) {
+		size_t result = unreached;
+		search(Q, starts, end, cost_fn, heuristic, [&](index_t, const point_t& p, size_t cost) {
+			if (p == end) {
+				result = cost;
+				return true;
+			}
+			return false;
+		});
+		return result;
+	}
+
+	/* Queue keys are cost + heuristic, less the first start's heuristic so
+	 * the first key is 0; with zero_heuristic_t that is Dijkstra. settled(u,
+	 * p, cost) is called as each state is popped for good and ends the
+	 * search by returning true. */
+	template <typename Queue, typename Heuristic, typename Settled>
+	void search(Queue& Q, std::span<const vector_t> starts, const point_t& end, cost_fn_t cost_fn,
+				const Heuristic& heuristic, Settled&& settled) {
+		auto started = std::chrono::steady_clock::now();
+		if (cost_fn == nullptr) {
+			cost_fn = default_cost;
+		}
+
+		begin_search(starts.empty() ? vector_t(point_t(0, 0), point_t(0, 0)) : starts[0]);
+
+		const size_t h_start = starts.empty() ? 0 : heuristic(starts[0].p, end);
+		auto key_of = [&](size_t cost, const point_t& p) { return cost + heuristic(p, end) - h_start; };
+
+		for (const vector_t& start : starts) {
+			if (_map.is_valid(start.p)) {
+				index_t s = index_of(start.p, heading_of(start.dir));
+				if (dist_of(s) != 0) {
+					reach(s, 0, start_bit);
+					Q.push(key_of(0, start.p), s);
+					stats.pushed++;
+				}
+			}
+		}
+
+		while (!Q.empty()) {
+			auto [key, u] = Q.pop();
+			stats.count_pop(Q.size());
+
+			const vector_t current = state_of(u);
+			const size_t cost = _states[u].dist;
+			if (key > key_of(cost, current.p)) {
+				stats.count_stale();
+				continue;  // already settled cheaper
+			}
+			stats.expanded++;
+
+			if (settled(u, current.p, cost)) {
+				break;
+			}
+
+			const auto u_bit = static_cast<mask_t>(1u << (u % slots));
+			Neighborhood::for_each_indexed([&](size_t heading, const offset_t& step) {
+				vector_t neighbor(current.p + step, step);
+				if (!_map.is_valid(neighbor.p)) {
+					return;
+				}
+				stats.count_relaxed();
+
+				size_t neighbor_cost = cost_fn(cost, current, neighbor, _map);
+				index_t v = index_of(neighbor.p, heading);
+				const size_t known = dist_of(v);
+				if (neighbor_cost < known) {
+					reach(v, neighbor_cost, u_bit);
+					Q.push(key_of(neighbor_cost, neighbor.p), v);
+					stats.pushed++;
+				} else if (neighbor_cost == known) {
+					_states[v].pred |= u_bit;
+				}
+			});
+		}
+
+		stats.count_bytes(Q.bytes() + bytes());
+		stats.elapsed_ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - started).count();
+	}
+
+	template <typename Queue>
+	size_t meet_in_middle(Queue& forward, const vector_t& start, const point_t& end, cost_fn_t cost_fn) {
+		auto started = std::chrono::steady_clock::now();
+		if (cost_fn == nullptr) {
+			cost_fn = default_cost;
+		}
+
+		if (_back_stamp.size() != _states.size()) {
+			_dist_back.assign(_states.size(), 0);
+			_next_back.assign(_states.size(), 0);
+			_back_stamp.assign(_states.size(), 0);
+		}
+		begin_search(start);
+
+		if (!_map.is_valid(start.p) || !_map.is_valid(end)) {
+			return unreached;
+		}
+
+		Queue backward = forward;
+		const index_t s = index_of(start.p, heading_of(start.dir));
+
+		auto reach_back = [&](index_t i, size_t cost, size_t heading) {
+			assert(cost <= dist_limit);
+			_back_stamp[i] = _generation;
+			_dist_back[i] = static_cast<Dist>(cost);
+			_next_back[i] = static_cast<uint8_t>(heading);
+		};
+
+		// cheapest start -> state -> end seen so far
+		size_t best = unreached;
+		index_t meet = s;
+		auto touch = [&](index_t i) {
+			const size_t ahead = dist_of(i);
+			const size_t behind = dist_back_of(i);
+			if (ahead != unreached && behind != unreached && ahead + behind < best) {
+				best = ahead + behind;
+				meet = i;
+			}
+		};
+
+		reach(s, 0, start_bit);
+		forward.push(0, s);
+		stats.pushed++;
+
+		// arriving at end by any step
+		Neighborhood::for_each_indexed([&](size_t heading, const offset_t& step) {
+			if (_map.is_valid(end - step)) {
+				index_t e = index_of(end, heading);
+				reach_back(e, 0, 0);
+				backward.push(0, e);
+				stats.pushed++;
+				touch(e);
+			}
+		});
+		if (start.p == end) {
+			reach_back(s, 0, 0);
+			touch(s);
+		}
+
+		// the cheapest live entry on each side, popped ahead of time; unreached once empty
+		using entry_t = std::pair<size_t, index_t>;
+		auto next_live = [&](auto& Q, auto&& dist) -> entry_t {
+			while (!Q.empty()) {
+				entry_t entry = Q.pop();
+				stats.count_pop(Q.size());
+				if (entry.first == dist(entry.second)) {
+					return entry;
+				}
+				stats.count_stale();
+			}
+			return {unreached, 0};
+		};
+		auto forward_dist = [&](index_t i) { return dist_of(i); };
+		auto backward_dist = [&](index_t i) { return dist_back_of(i); };
+
+		entry_t ahead = next_live(forward, forward_dist);
+		entry_t behind = next_live(backward, backward_dist);
+
+		// nothing left on either side can make a cheaper meeting
+		while (ahead.first != unreached && behind.first != unreached && ahead.first + behind.first < best) {
+			stats.expanded++;
+
+			if (ahead.first <= behind.first) {
+				auto [cost, u] = ahead;
+				const vector_t current = state_of(u);
+				const auto u_bit = static_cast<mask_t>(1u << (u % slots));
+
+				Neighborhood::for_each_indexed([&](size_t heading, const offset_t& step) {
+					vector_t neighbor(current.p + step, step);
+					if (!_map.is_valid(neighbor.p)) {
+						return;
+					}
+					stats.count_relaxed();
+
+					size_t neighbor_cost = cost_fn(cost, current, neighbor, _map);
+					index_t v = index_of(neighbor.p, heading);
+					const size_t known = dist_of(v);
+					if (neighbor_cost < known) {
+						reach(v, neighbor_cost, u_bit);
+						forward.push(neighbor_cost, v);
+						stats.pushed++;
+						touch(v);
+					} else if (neighbor_cost == known) {
+						_states[v].pred |= u_bit;
+					}
+				});
+				ahead = next_live(forward, forward_dist);
+
+			} else {
+				auto [cost, v] = behind;
+				const size_t heading = v % slots;
+				if (heading != no_heading) {
+					// every state on the tile one step back leads here
+					const vector_t target = state_of(v);
+					const point_t from = target.p - Neighborhood::steps[heading];
+
+					for (size_t h = 0; h <= no_heading; h++) {
+						index_t u = index_of(from, h);
+						bool exists = u == s || (h != no_heading && _map.is_valid(from - Neighborhood::steps[h]));
+						if (!exists) {
+							continue;
+						}
+						stats.count_relaxed();
+
+						size_t prior_cost = cost + cost_fn(0, state_of(u), target, _map);
+						if (prior_cost < dist_back_of(u)) {
+							reach_back(u, prior_cost, heading);
+							backward.push(prior_cost, u);
+							stats.pushed++;
+							touch(u);
+						}
+					}
+				}
+				behind = next_live(backward, backward_dist);
+			}
+		}
+
+		if (best != unreached) {
+			// carry the forward dist and pred on along the backward half to end
+			for (index_t i = meet; state_of(i).p != end;) {
+				const size_t heading = _next_back[i];
+				const index_t j = index_of(state_of(i).p + Neighborhood::steps[heading], heading);
+				const size_t cost = size_t{_states[i].dist} + (size_t{_dist_back[i]} - _dist_back[j]);
+				const auto i_bit = static_cast<mask_t>(1u << (i % slots));
+				const size_t known = dist_of(j);
+
+				if (cost < known) {
+					reach(j, cost, i_bit);
+				} else if (cost == known) {
+					_states[j].pred |= i_bit;
+				}
+				i = j;
+			}
+		}
+
+		stats.count_bytes(forward.bytes() + backward.bytes() + bytes());
+		stats.elapsed_ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - started).count();
+		return best;
+	}
+};
+
+// a map is not silently turned into a whole search workspace
+static_assert(!std::is_convertible_v<const charmap_t&, grid_dijkstra_t<>>);
+
+/* Dijkstra over the map; the states are (position, direction we moved to get there).
+ * Neighborhood is the set of moves allowed, von_neumann_t (4) by default.
+ * max_weight, the most a step can cost if known, picks the queue.
+ * Returns, min_cost, dist[], pred[]; the search runs in grid_dijkstra_t,
+ * use that directly to skip building the maps.
+ */
+template <typename Neighborhood = von_neumann_t>
 std::tuple<size_t, dist_t, pred_t> dijkstra(
 	const charmap_t& map,
 	const vector_t& start,
 	const point_t& end,
-	size_t (*cost_fn)(const size_t cost,
-					  const vector_t& current, const vector_t& neighbor,
-					  const charmap_t& map) = nullptr);
+	cost_fn_t cost_fn = nullptr,
+	size_t max_weight = 0) {
+	dist_t dist;
+	pred_t pred;
+
+	grid_dijkstra_t<Neighborhood> search(map);
+	size_t cost = search.run(start, end, cost_fn, max_weight);
+	search.export_maps(dist, pred);
+
+	return {cost == search.unreached ? INT_MAX : cost, dist, pred};
+}
+
+/* A* over the map, otherwise as dijkstra(); the heuristic estimates the
+ * cost left from a tile to end, manhattan_heuristic_t by default. Use
+ * chebyshev_heuristic_t with moore_t. pred holds at least one cheapest path.
+ */
+template <typename Neighborhood = von_neumann_t, typename Heuristic = manhattan_heuristic_t>
+std::tuple<size_t, dist_t, pred_t> astar(
+	const charmap_t& map,
+	const vector_t& start,
+	const point_t& end,
+	Heuristic heuristic = {},
+	cost_fn_t cost_fn = nullptr,
+	size_t max_weight = 0) {
+	dist_t dist;
+	pred_t pred;
+
+	grid_dijkstra_t<Neighborhood> search(map);
+	size_t cost = search.astar(start, end, heuristic, cost_fn, max_weight);
+	search.export_maps(dist, pred);
+
+	return {cost == search.unreached ? INT_MAX : cost, dist, pred};
+}
+
+/* Dijkstra from both ends, otherwise as dijkstra(); cost_fn must be additive
+ * (default_cost is). pred holds at least one cheapest path.
+ */
+template <typename Neighborhood = von_neumann_t>
+std::tuple<size_t, dist_t, pred_t> bidirectional_dijkstra(
+	const charmap_t& map,
+	const vector_t& start,
+	const point_t& end,
+	cost_fn_t cost_fn = nullptr,
+	size_t max_weight = 0) {
+	dist_t dist;
+	pred_t pred;
+
+	grid_dijkstra_t<Neighborhood> search(map);
+	size_t cost = search.bidirectional(start, end, cost_fn, max_weight);
+	search.export_maps(dist, pred);
+
+	return {cost == search.unreached ? INT_MAX : cost, dist, pred};
+}
+
+/* Return the distance of point p from the start using the precomputed dist[]. */
+template <typename Neighborhood = von_neumann_t>
+size_t dijkstra_distance(const charmap_t& map, const dist_t& dist, const point_t& p) {
+	if (map.is_char(p.x, p.y, 'S')) {
+		return 0;
+	}
+
+	size_t distance = INT_MAX;
+	Neighborhood::for_each([&](const offset_t& dir) {
+		vector_t v{p.x, p.y, dir.dx, dir.dy};
+
+		auto dit = dist.find(v);
+		if (dit != dist.end()) {
+			size_t d = dit->second;
+			if (d && d < distance) {
+				distance = d;
+			}
+		}
+	});
+	return distance;
+}
+
+/* Return the tiles on the paths back to the start from the states in from,
+ * through pred; each tile once, nearest the end first. */
+inline std::vector<point_t> dijkstra_path_from(const std::vector<vector_t>& from, const pred_t& pred) {
+	std::vector<point_t> path;
+	std::set<point_t> tiles;
+	std::set<vector_t> seen(from.begin(), from.end());
+	std::queue<vector_t> Q;
+	for (const auto& v : from) {
+		Q.push(v);
+	}
+
+	// run backwards looking for all the tiles we hit, each state once
+	while (!Q.empty()) {
+		auto vertex = Q.front();
+		Q.pop();
+
+		if (tiles.insert(vertex.p).second) {
+			path.push_back(vertex.p);
+		}
+
+		auto pit = pred.find(vertex);
+		if (pit != pred.end()) {
+			for (const auto& predecessor : pit->second) {
+				if (seen.insert(predecessor).second) {
+					Q.push(predecessor);
+				}
+			}
+		}
+	}
+
+	return path;
+}
+
+/* Return the path from start to end using precomputed pred, from every
+ * direction into end. */
+template <typename Neighborhood = von_neumann_t>
+std::vector<point_t> dijkstra_path(const point_t& end, const pred_t& pred) {
+	std::vector<vector_t> from;
+	Neighborhood::for_each([&](const offset_t& direction) {
+		from.push_back({end, direction});
+	});
+	return dijkstra_path_from(from, pred);
+}
+
+/* As above, only from the directions into end that are cheapest in dist,
+ * so the tiles are those on a cheapest path. grid_dijkstra_t's
+ * for_each_path_tile() does the same without the maps. */
+template <typename Neighborhood = von_neumann_t>
+std::vector<point_t> dijkstra_path(const point_t& end, const dist_t& dist, const pred_t& pred) {
+	// every direction in, and none for when end is the start
+	std::vector<vector_t> into = {{end, point_t(0, 0)}};
+	Neighborhood::for_each([&](const offset_t& direction) {
+		into.push_back({end, direction});
+	});
+
+	size_t best = SIZE_MAX;
+	for (const auto& v : into) {
+		auto dit = dist.find(v);
+		if (dit != dist.end()) {
+			best = std::min(best, dit->second);
+		}
+	}
+
+	std::vector<vector_t> from;
+	for (const auto& v : into) {
+		auto dit = dist.find(v);
+		if (dit != dist.end() && dit->second == best) {
+			from.push_back(v);
+		}
+	}
+	return dijkstra_path_from(from, pred);
+}
 
-size_t dijkstra_distance(const charmap_t& map, const dist_t& dist, const point_t& p);
-std::vector<point_t> dijkstra_path(const point_t& end, const pred_t& pred);
 void show_dijkstra_distances(const charmap_t& map, const dist_t& dist);
 
 #endif
@@ -0,0 +1,384 @@
+#if !defined(FLAT_HASH_H)
+#define FLAT_HASH_H
+
+#include <cstddef>
+#include <cstdint>
+#include <functional>  // std::hash, std::equal_to
+#include <iterator>
+#include <stdexcept>  // std::out_of_range
+#include <string_view>
+#include <type_traits>  // std::conditional_t
+#include <utility>	   // std::pair
+#include <vector>
+
+#include "hash.h"
+
+/* Open addressing hash set and map (flat_hash_set, flat_hash_map).
+ *
+ * All the entries live in one contiguous array, probed linearly from the
+ * slot picked by hash_mix(Hash(key)). A parallel array of one byte tags holds
+ * 7 bits of the hash for each slot, so most probes that miss never touch the
+ * (much larger) key array. Erase shifts following entries back instead of
+ * leaving tombstones, so long-lived visited sets do not degrade.
+ *
+ * Differences from unordered_set/map:
+ * - keys and values must be default constructible (point_t, vector_t, ints...)
+ * - inserting can move every entry; iterators and references do not survive
+ *   an insert that grows the table, or any erase
+ * - the map's value_type is std::pair<Key, Value>; do not change the key
+ * - find(), contains() and count() take other key types (a string_view into
+ *   a map of strings) when Hash and Eq both declare is_transparent, as with
+ *   flat_hash_string_hash and std::equal_to<>
+ */
+template <typename Key, typename Slot, typename KeyOf, typename Hash, typename Eq>
+class flat_hash_table {
+   public:
+	using key_type = Key;
+	using value_type = Slot;
+	using size_type = size_t;
+
+	template <bool Const>
+	class basic_iterator {
+		using table_t = std::conditional_t<Const, const flat_hash_table, flat_hash_table>;
+
+		table_t* table = nullptr;
+		size_t i = 0;
+
+		void skip_empty() {
+			while (i < table->_tags.size() && table->_tags[i] == 0) {
+				++i;
+			}
+		}
+
+		friend class flat_hash_table;
+
+	   public:
+		using iterator_category = std::forward_iterator_tag;
+		using value_type = Slot;
+		using difference_type = std::ptrdiff_t;
+		using pointer = std::conditional_t<Const, const Slot*, Slot*>;
+		using reference = std::conditional_t<Const, const Slot&, Slot&>;
+
+		basic_iterator() = default;
+		basic_iterator(table_t* table, size_t i) : table(table), i(i) {
+			skip_empty();
+		}
+
+		// iterator converts to const_iterator
+		operator basic_iterator<true>() const {
+			return {table, i};
+		}
+
+		reference operator*() const { return table->_slots[i]; }
+		pointer operator->() const { return &table->_slots[i]; }
+
+		basic_iterator& operator++() {
+			++i;
+			skip_empty();
+			return *this;
+		}
+
+		basic_iterator operator++(int) {
+			basic_iterator before = *this;
+			++(*this);
+			return before;
+		}
+
+		bool operator==(const basic_iterator& other) const { return i == other.i; }
+	};
+
+	using iterator = basic_iterator<false>;
+	using const_iterator = basic_iterator<true>;
+
+	flat_hash_table() = default;
+
+	explicit flat_hash_table(size_t expected) {
+		reserve(expected);
+	}
+
+	iterator begin() { return {this, 0}; }
+	iterator end() { return {this, _tags.size()}; }
+	const_iterator begin() const { return {this, 0}; }
+	const_iterator end() const { return {this, _tags.size()}; }
+
+	size_t size() const { return _size; }
+	bool empty() const { return _size == 0; }
+	size_t capacity() const { return _tags.size(); }
+
+	void clear() {
+		for (size_t i = 0; i < _tags.size(); i++) {
+			if (_tags[i]) {
+				_tags[i] = 0;
+				_slots[i] = Slot{};
+			}
+		}
+		_size = 0;
+	}
+
+	// make room for n entries without growing again
+	void reserve(size_t n) {
+		size_t wanted = 16;
+		while (wanted * max_load_num < n * max_load_den) {
+			wanted *= 2;
+		}
+
+		if (wanted > _tags.size()) {
+			rehash(wanted);
+		}
+	}
+
+	iterator find(const Key& key) {
+		return {this, find_index(key)};
+	}
+
+	const_iterator find(const Key& key) const {
+		return {this, find_index(key)};
+	}
+
+	bool contains(const Key& key) const {
+		return find_index(key) != _tags.size();
+	}
+
+	size_t count(const Key& key) const {
+		return contains(key) ? 1 : 0;
+	}
+
+	// lookup without building a Key, when Hash and Eq are transparent
+	static constexpr bool transparent = requires {
+		typename Hash::is_transparent;
+		typename Eq::is_transparent;
+	};
+
+	template <typename K>
+		requires transparent
+	iterator find(const K& key) {
+		return {this, find_index(key)};
+	}
+
+	template <typename K>
+		requires transparent
+	const_iterator find(const K& key) const {
+		return {this, find_index(key)};
+	}
+
+	template <typename K>
+		requires transparent
+	bool contains(const K& key) const {
+		return find_index(key) != _tags.size();
+	}
+
+	template <typename K>
+		requires transparent
+	size_t count(const K& key) const {
+		return contains(key) ? 1 : 0;
+	}
+
+	size_t erase(const Key& key) {
+		size_t hole = find_index(key);
+		if (hole == _tags.size()) {
+			return 0;
+		}
+
+		// shift back any entry whose probe sequence runs through the hole
+		size_t k = hole;
+		while (true) {
+			k = (k + 1) & _mask;
+			if (_tags[k] == 0) {
+				break;
+			}
+
+			size_t home = hash_of(KeyOf{}(_slots[k])) & _mask;
+			if (((k - home) & _mask) < ((k - hole) & _mask)) {
+				continue;
+			}
+
+			_tags[hole] = _tags[k];
+			_slots[hole] = std::move(_slots[k]);
+			hole = k;
+		}
+
+		_tags[hole] = 0;
+		_slots[hole] = Slot{};
+		--_size;
+		return 1;
+	}
+
+   protected:
+	/* Returns the slot index for key and true if it was added. A new slot is
+	 * set to make() before it is marked full, so if building the entry throws
+	 * the table still holds just what it did. */
+	template <typename Make>
+	std::pair<size_t, bool> insert_index(const Key& key, Make&& make) {
+		size_t h = hash_of(key);
+		uint8_t tag = tag_of(h);
+
+		// look first, so a key already there never grows the table
+		size_t i = h & _mask;
+		if (!_tags.empty()) {
+			for (; _tags[i] != 0; i = (i + 1) & _mask) {
+				if (_tags[i] == tag && Eq{}(KeyOf{}(_slots[i]), key)) {
+					return {i, false};
+				}
+			}
+		}
+
+		if ((_size + 1) * max_load_den > _tags.size() * max_load_num) {
+			rehash(_tags.empty() ? 16 : _tags.size() * 2);
+			for (i = h & _mask; _tags[i] != 0; i = (i + 1) & _mask) {
+			}
+		}
+
+		_slots[i] = make();
+		_tags[i] = tag;
+		++_size;
+		return {i, true};
+	}
+
+	template <typename K>
+	size_t find_index(const K& key) const {
+		if (_size == 0) {
+			return _tags.size();
+		}
+
+		size_t h = hash_of(key);
+		uint8_t tag = tag_of(h);
+		for (size_t i = h & _mask;; i = (i + 1) & _mask) {
+			if (_tags[i] == 0) {
+				return _tags.size();
+			}
+
+			if (_tags[i] == tag && Eq{}(KeyOf{}(_slots[i]), key)) {
+				return i;
+			}
+		}
+	}
+
+	Slot& slot(size_t i) { return _slots[i]; }
+
+   private:
+	// grow when more than 7/8 full
+	static constexpr size_t max_load_num = 7;
+	static constexpr size_t max_load_den = 8;
+
+	std::vector<uint8_t> _tags = {};  // 0 = empty, 0x80 | top 7 bits of hash = full
+	std::vector<Slot> _slots = {};
+	size_t _size = 0;
+	size_t _mask = 0;
+
+	template <typename K>
+	static size_t hash_of(const K& key) {
+		return static_cast<size_t>(hash_mix(static_cast<uint64_t>(Hash{}(key))));
+	}
+
+	static uint8_t tag_of(size_t h) {
+		return static_cast<uint8_t>(0x80 | (h >> 57));
+	}
+
+	void rehash(size_t new_capacity) {
+		std::vector<uint8_t> old_tags(new_capacity, 0);
+		std::vector<Slot> old_slots(new_capacity);
+		old_tags.swap(_tags);
+		old_slots.swap(_slots);
+		_mask = new_capacity - 1;
+
+		for (size_t i = 0; i < old_tags.size(); i++) {
+			if (old_tags[i]) {
+				size_t h = hash_of(KeyOf{}(old_slots[i]));
+				size_t j = h & _mask;
+				while (_tags[j]) {
+					j = (j + 1) & _mask;
+				}
+
+				_tags[j] = old_tags[i];
+				_slots[j] = std::move(old_slots[i]);
+			}
+		}
+	}
+};
+
+/* Hashes std::string and std::string_view alike (std::hash gives them the
+ * same value), so a map keyed on strings can be searched with a view. */
+struct flat_hash_string_hash {
+	using is_transparent = void;
+
+	size_t operator()(std::string_view s) const { return std::hash<std::string_view>{}(s); }
+};
+
+struct flat_hash_key_of_self {
+	template <typename T>
+	const T& operator()(const T& t) const { return t; }
+};
+
+struct flat_hash_key_of_first {
+	template <typename T>
+	const auto& operator()(const T& t) const { return t.first; }
+};
+
+template <typename Key, typename Hash = std::hash<Key>, typename Eq = std::equal_to<Key>>
+class flat_hash_set : public flat_hash_table<Key, Key, flat_hash_key_of_self, Hash, Eq> {
+	using base_t = flat_hash_table<Key, Key, flat_hash_key_of_self, Hash, Eq>;
+
+   public:
+	using base_t::base_t;
+	using typename base_t::iterator;
+
+	std::pair<iterator, bool> insert(const Key& key) {
+		auto [i, inserted] = this->insert_index(key, [&]() { return key; });
+		return {{this, i}, inserted};
+	}
+};
+
+template <typename Key, typename Value, typename Hash = std::hash<Key>, typename Eq = std::equal_to<Key>>
+class flat_hash_map : public flat_hash_table<Key, std::pair<Key, Value>, flat_hash_key_of_first, Hash, Eq> {
+	using base_t = flat_hash_table<Key, std::pair<Key, Value>, flat_hash_key_of_first, Hash, Eq>;
+
+   public:
+	using mapped_type = Value;
+	using base_t::base_t;
+	using typename base_t::iterator;
+
+	template <typename... Args>
+	std::pair<iterator, bool> try_emplace(const Key& key, Args&&... args) {
+		auto [i, inserted] = this->insert_index(key, [&]() {
+			return std::pair<Key, Value>(key, Value(std::forward<Args>(args)...));
+		});
+		return {{this, i}, inserted};
+	}
+
+	std::pair<iterator, bool> insert(const std::pair<Key, Value>& kv) {
+		return try_emplace(kv.first, kv.second);
+	}
+
+	template <typename V>
+	std::pair<iterator, bool> insert_or_assign(const Key& key, V&& value) {
+		auto [i, inserted] = this->insert_index(key, [&]() { return std::pair<Key, Value>(key, std::forward<V>(value)); });
+		if (!inserted) {
+			this->slot(i).second = std::forward<V>(value);
+		}
+		return {{this, i}, inserted};
+	}
+
+	Value& operator[](const Key& key) {
+		auto [i, inserted] = this->insert_index(key, [&]() { return std::pair<Key, Value>(key, Value()); });
+		return this->slot(i).second;
+	}
+
+	// like std::map, std::out_of_range if key is not there
+	Value& at(const Key& key) {
+		auto it = this->find(key);
+		if (it == this->end()) {
+			throw std::out_of_range("flat_hash_map::at");
+		}
+		return it->second;
+	}
+
+	const Value& at(const Key& key) const {
+		auto it = this->find(key);
+		if (it == this->end()) {
+			throw std::out_of_range("flat_hash_map::at");
+		}
+		return it->second;
+	}
+};
+
+#endif
@@ -0,0 +1,110 @@
+#if !defined(GRAPH_H)
+#define GRAPH_H
+
+#include <cstddef>
+#include <cstdint>
+#include <functional>  // std::equal_to
+#include <optional>
+#include <span>
+#include <string>
+#include <string_view>
+#include <utility>	// std::pair
+#include <vector>
+
+#include "flat_hash.h"
+
+using node_t = uint32_t;
+
+/* Directed graph in compressed sparse row form; nodes are 0..size()-1 and
+ * the edges out of node u are targets[offsets[u]] .. targets[offsets[u+1]-1].
+ * Walking a node's neighbours is a walk along one array, no lookups.
+ *
+ * Nodes can have names (from parse_graph()); id_of() maps a name back to its
+ * node, no_node if there is no such name.
+ *
+ *	mapped_file_t file(filename);
+ *	graph_t network = parse_graph(file.view());
+ *	for (node_t v : network.neighbors(network.id_of("you"))) { ... }
+ */
+class graph_t {
+   public:
+	static constexpr node_t no_node = UINT32_MAX;
+
+	std::vector<uint32_t> offsets = {0};  // size() + 1 entries
+	std::vector<node_t> targets = {};
+	std::vector<std::string> names = {};  // empty, or one per node
+
+	/* From (from, to) edges over nodes 0..nodes-1; each node's edges keep
+	 * the order they were given in. */
+	static graph_t from_edges(size_t nodes, const std::vector<std::pair<node_t, node_t>>& edges);
+
+	size_t size() const { return offsets.size() - 1; }
+	size_t edge_count() const { return targets.size(); }
+
+	std::span<const node_t> neighbors(node_t u) const {
+		return {targets.data() + offsets[u], targets.data() + offsets[u + 1]};
+	}
+
+	size_t degree(node_t u) const { return offsets[u + 1] - offsets[u]; }
+
+	node_t id_of(std::string_view name) const;
+	std::string_view name_of(node_t u) const { return names[u]; }
+
+	/* The same graph with every edge turned around (names kept). */
+	graph_t reverse() const;
+
+   private:
+	flat_hash_map<std::string, node_t, flat_hash_string_hash, std::equal_to<>> _ids = {};  // found by string_view
+
+	friend graph_t parse_graph(std::string_view text);
+};
+
+/* Read "name: a b c" adjacency lines (day 11); every name on either side
+ * becomes a node, numbered in the order first seen. Names are interned as
+ * they are scanned, straight out of the buffer. */
+graph_t parse_graph(std::string_view text);
+
+/* Nodes so every edge goes from earlier to later (Kahn's algorithm). Nodes
+ * on a cycle, or only reachable through one, are left out, so the order is
+ * shorter than size() exactly when the graph has a cycle. */
+std::vector<node_t> topological_order(const graph_t& graph);
+
+/* The same, over only the nodes reachable from start (start first). Cycles
+ * elsewhere in the graph don't matter; std::nullopt if one can be reached
+ * from start. */
+std::optional<std::vector<node_t>> topological_order(const graph_t& graph, node_t start);
+
+/* Strongly connected components, by Tarjan's algorithm with the recursion
+ * kept on an explicit stack. Components are numbered 0..count-1 in reverse
+ * topological order: edges between components only go to lower numbers. */
+struct components_t {
+	std::vector<node_t> component = {};	 // per node
+	size_t count = 0;
+};
+
+components_t strongly_connected_components(const graph_t& graph);
+
+/* One node per component and an edge for every edge between two of them
+ * (repeats kept); always a DAG. */
+graph_t condense(const graph_t& graph, const components_t& components);
+
+/* Dynamic programming down a DAG: for each u in order, and each edge u -> v,
+ * combine(values[v], values[u], u, v). Everything before u has been folded
+ * in by the time u is reached, so each values[u] passed on is final. order
+ * is from topological_order(); one linear sweep, no recursion.
+ *
+ *	std::vector<size_t> paths(graph.size(), 0);
+ *	paths[start] = 1;
+ *	paths = fold_dag(graph, order, std::move(paths), [](size_t& to, size_t from, node_t, node_t) { to += from; });
+ */
+template <typename T, typename Combine>
+std::vector<T> fold_dag(const graph_t& graph, std::span<const node_t> order, std::vector<T> values, Combine&& combine) {
+	for (node_t u : order) {
+		for (node_t v : graph.neighbors(u)) {
+			combine(values[v], values[u], u, v);
+		}
+	}
+	return values;
+}
+
+#endif
@@ -0,0 +1,208 @@
+#if !defined(KD_TREE_H)
+#define KD_TREE_H
+
+#include <algorithm>  // nth_element, push_heap, pop_heap, sort_heap
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <span>
+#include <utility>	// std::pair
+#include <vector>
+
+#include "parallel.h"
+#include "point.h"
+
+/* Static k-d tree over 2D or 3D points (point<N, T>) for nearest neighbour
+ * and radius queries.
+ *
+ * The tree is implicit: the points are reordered so the node for
+ * a range [lo, hi) is the median at (lo + hi) / 2, splitting on axis
+ * depth % N, with its left subtree in [lo, mid) and right in [mid + 1, hi).
+ * No child pointers, no per-node allocation; one array of points and one
+ * of their original indices.
+ *
+ * Query results are indices into the points the tree was built from.
+ * Distances are squared euclidean, as dimension_t.
+ *
+ *	kd_tree_t<3, int32_t> tree(points);
+ *	auto five = tree.nearest(points[0], 5);			// includes points[0] itself
+ *	auto near = tree.within(points[0], 1000 * 1000);	// radius 1000
+ */
+template <size_t N, typename T>
+class kd_tree_t {
+   public:
+	using point_type = point<N, T>;
+	using neighbor_t = std::pair<dimension_t, size_t>;	// squared distance, index
+
+	// fills the rows of all_nearest() past the last real neighbour
+	static constexpr neighbor_t no_neighbor = {std::numeric_limits<dimension_t>::max(), std::numeric_limits<size_t>::max()};
+
+	kd_tree_t() {}
+
+	explicit kd_tree_t(std::span<const point_type> points) {
+		std::vector<std::pair<point_type, size_t>> nodes(points.size());
+		for (size_t i = 0; i < points.size(); i++) {
+			nodes[i] = {points[i], i};
+		}
+
+		build(nodes, 0, nodes.size(), 0);
+
+		_points.reserve(nodes.size());
+		_index.reserve(nodes.size());
+		for (const auto& [p, i] : nodes) {
+			_points.push_back(p);
+			_index.push_back(i);
+		}
+	}
+
+	/* Build from any container of points that convert to point_type (e.g. point_t). */
+	template <typename C>
+	static kd_tree_t from_points(const C& points) {
+		std::vector<point_type> converted;
+		converted.reserve(points.size());
+		for (const auto& p : points) {
+			converted.emplace_back(p);
+		}
+		return kd_tree_t(converted);
+	}
+
+	size_t size() const { return _points.size(); }
+
+	/* The k points closest to q, closest first. Skips the point with
+	 * index exclude (pass a point's own index to leave it out). */
+	std::vector<neighbor_t> nearest(const point_type& q, size_t k,
+									size_t exclude = std::numeric_limits<size_t>::max()) const {
+		std::vector<neighbor_t> heap;
+		heap.reserve(k + 1);
+		nearest(q, k, exclude, heap);
+		return heap;
+	}
+
+	/* As above, but into a caller-owned buffer (cleared first) to avoid allocating per query. */
+	void nearest(const point_type& q, size_t k, size_t exclude, std::vector<neighbor_t>& heap) const {
+		heap.clear();
+		if (k > 0) {
+			search_nearest(q, k, exclude, 0, _points.size(), 0, heap);
+			std::sort_heap(heap.begin(), heap.end());
+		}
+	}
+
+	/* Every point within sq_radius (inclusive) of q, in no particular order. */
+	std::vector<neighbor_t> within(const point_type& q, dimension_t sq_radius) const {
+		std::vector<neighbor_t> found;
+		search_within(q, sq_radius, 0, _points.size(), 0, found);
+		return found;
+	}
+
+	/* The k nearest neighbours of every point (not counting itself), spread
+	 * across the pool's threads. Returns size() * k entries, row i holding
+	 * point i's neighbours closest first; with fewer than k other points the
+	 * rest of each row is no_neighbor. */
+	std::vector<neighbor_t> all_nearest(size_t k, thread_pool_t& pool = thread_pool_t::shared()) const {
+		std::vector<neighbor_t> result(_points.size() * k, no_neighbor);
+
+		pool.parallel_for(_points.size(), [&](size_t begin, size_t end) {
+			std::vector<neighbor_t> heap;
+			heap.reserve(k + 1);
+			for (size_t pos = begin; pos < end; pos++) {
+				// walk in tree order so neighbouring queries share cache
+				size_t i = _index[pos];
+				nearest(_points[pos], k, i, heap);
+				std::copy(heap.begin(), heap.end(), result.begin() + static_cast<std::ptrdiff_t>(i * k));
+			}
+		}, 256);
+
+		return result;
+	}
+
+   private:
+	std::vector<point_type> _points = {};
+	std::vector<size_t> _index = {};  // original index of each point in _points
+
+	static void build(std::vector<std::pair<point_type, size_t>>& nodes, size_t lo, size_t hi, size_t depth) {
+		while (hi - lo > 1) {
+			size_t mid = lo + (hi - lo) / 2;
+			size_t axis = depth % N;
+
+			auto first = nodes.begin();
+			std::nth_element(first + static_cast<std::ptrdiff_t>(lo),
+							 first + static_cast<std::ptrdiff_t>(mid),
+							 first + static_cast<std::ptrdiff_t>(hi),
+							 [axis](const auto& a, const auto& b) { return a.first[axis] < b.first[axis]; });
+
+			build(nodes, lo, mid, depth + 1);
+			lo = mid + 1;
+			depth++;
+		}
+	}
+
+	void search_nearest(const point_type& q, size_t k, size_t exclude,
+						size_t lo, size_t hi, size_t depth, std::vector<neighbor_t>& heap) const {
+		while (lo < hi) {
+			size_t mid = lo + (hi - lo) / 2;
+			size_t axis = depth % N;
+			const point_type& p = _points[mid];
+
+			if (_index[mid] != exclude) {
+				dimension_t d = sq_distance(q, p);
+				if (heap.size() < k || d < heap.front().first) {
+					heap.emplace_back(d, _index[mid]);
+					std::push_heap(heap.begin(), heap.end());
+					if (heap.size() > k) {
+						std::pop_heap(heap.begin(), heap.end());
+						heap.pop_back();
+					}
+				}
+			}
+
+			dimension_t diff = static_cast<dimension_t>(q[axis]) - static_cast<dimension_t>(p[axis]);
+			bool left_first = diff < 0;
+
+			// near side first, then the far side only if it could hold something closer
+			if (left_first) {
+				search_nearest(q, k, exclude, lo, mid, depth + 1, heap);
+			} else {
+				search_nearest(q, k, exclude, mid + 1, hi, depth + 1, heap);
+			}
+
+			if (heap.size() == k && diff * diff >= heap.front().first) {
+				return;
+			}
+
+			if (left_first) {
+				lo = mid + 1;
+			} else {
+				hi = mid;
+			}
+			depth++;
+		}
+	}
+
+	void search_within(const point_type& q, dimension_t sq_radius,
+					   size_t lo, size_t hi, size_t depth, std::vector<neighbor_t>& found) const {
+		while (lo < hi) {
+			size_t mid = lo + (hi - lo) / 2;
+			size_t axis = depth % N;
+			const point_type& p = _points[mid];
+
+			dimension_t d = sq_distance(q, p);
+			if (d <= sq_radius) {
+				found.emplace_back(d, _index[mid]);
+			}
+
+			dimension_t diff = static_cast<dimension_t>(q[axis]) - static_cast<dimension_t>(p[axis]);
+			if (diff * diff <= sq_radius) {
+				// the ball crosses the split, search both sides
+				search_within(q, sq_radius, lo, mid, depth + 1, found);
+				lo = mid + 1;
+			} else if (diff < 0) {
+				hi = mid;
+			} else {
+				lo = mid + 1;
+			}
+			depth++;
+		}
+	}
+};
+
+#endif
@@ -0,0 +1,181 @@
+#if !defined(MORTON_H)
+#define MORTON_H
+
+#include <algorithm>  // sort, min
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <tuple>
+#include <utility>	// std::pair
+#include <vector>
+
+#if defined(__BMI2__)
+#include <immintrin.h>	// _pdep_u64, _pext_u64
+#endif
+
+#include "point.h"
+
+/* Morton (Z-order) codes; interleave the bits of the coordinates so points
+ * that are close in space get codes that are close as numbers.
+ *
+ *	2D: 32 bits per axis, x in the even bits, y in the odd bits
+ *	3D: 21 bits per axis, x in bits 0, 3, 6..., y in 1, 4, 7..., z in 2, 5, 8...
+ *
+ * Uses BMI2 pdep/pext when compiled for it (-mbmi2 or -march=native),
+ * otherwise the usual shift-and-mask bit spreading.
+ */
+constexpr uint64_t morton_mask2 = 0x5555555555555555ull;
+constexpr uint64_t morton_mask3 = 0x1249249249249249ull;
+
+// 0b abcd -> 0b 0a0b0c0d
+constexpr uint64_t morton_spread2(uint64_t v) {
+	v &= 0xffffffffull;
+	v = (v | (v << 16)) & 0x0000ffff0000ffffull;
+	v = (v | (v << 8)) & 0x00ff00ff00ff00ffull;
+	v = (v | (v << 4)) & 0x0f0f0f0f0f0f0f0full;
+	v = (v | (v << 2)) & 0x3333333333333333ull;
+	v = (v | (v << 1)) & 0x5555555555555555ull;
+	return v;
+}
+
+constexpr uint32_t morton_compact2(uint64_t v) {
+	v &= 0x5555555555555555ull;
+	v = (v | (v >> 1)) & 0x3333333333333333ull;
+	v = (v | (v >> 2)) & 0x0f0f0f0f0f0f0f0full;
+	v = (v | (v >> 4)) & 0x00ff00ff00ff00ffull;
+	v = (v | (v >> 8)) & 0x0000ffff0000ffffull;
+	v = (v | (v >> 16)) & 0x00000000ffffffffull;
+	return static_cast<uint32_t>(v);
+}
+
+// 0b abcd -> 0b 00a00b00c00d
+constexpr uint64_t morton_spread3(uint64_t v) {
+	v &= 0x1fffffull;
+	v = (v | (v << 32)) & 0x001f00000000ffffull;
+	v = (v | (v << 16)) & 0x001f0000ff0000ffull;
+	v = (v | (v << 8)) & 0x100f00f00f00f00full;
+	v = (v | (v << 4)) & 0x10c30c30c30c30c3ull;
+	v = (v | (v << 2)) & 0x1249249249249249ull;
+	return v;
+}
+
+constexpr uint32_t morton_compact3(uint64_t v) {
+	v &= 0x1249249249249249ull;
+	v = (v ^ (v >> 2)) & 0x10c30c30c30c30c3ull;
+	v = (v ^ (v >> 4)) & 0x100f00f00f00f00full;
+	v = (v ^ (v >> 8)) & 0x001f0000ff0000ffull;
+	v = (v ^ (v >> 16)) & 0x001f00000000ffffull;
+	v = (v ^ (v >> 32)) & 0x00000000001fffffull;
+	return static_cast<uint32_t>(v);
+}
+
+inline uint64_t morton_encode(uint32_t x, uint32_t y) {
+#if defined(__BMI2__)
+	return _pdep_u64(x, morton_mask2) | _pdep_u64(y, morton_mask2 << 1);
+#else
+	return morton_spread2(x) | (morton_spread2(y) << 1);
+#endif
+}
+
+// x, y and z must fit in 21 bits
+inline uint64_t morton_encode(uint32_t x, uint32_t y, uint32_t z) {
+#if defined(__BMI2__)
+	return _pdep_u64(x, morton_mask3) | _pdep_u64(y, morton_mask3 << 1) | _pdep_u64(z, morton_mask3 << 2);
+#else
+	return morton_spread3(x) | (morton_spread3(y) << 1) | (morton_spread3(z) << 2);
+#endif
+}
+
+inline std::pair<uint32_t, uint32_t> morton_decode2(uint64_t code) {
+#if defined(__BMI2__)
+	return {static_cast<uint32_t>(_pext_u64(code, morton_mask2)),
+			static_cast<uint32_t>(_pext_u64(code, morton_mask2 << 1))};
+#else
+	return {morton_compact2(code), morton_compact2(code >> 1)};
+#endif
+}
+
+inline std::tuple<uint32_t, uint32_t, uint32_t> morton_decode3(uint64_t code) {
+#if defined(__BMI2__)
+	return {static_cast<uint32_t>(_pext_u64(code, morton_mask3)),
+			static_cast<uint32_t>(_pext_u64(code, morton_mask3 << 1)),
+			static_cast<uint32_t>(_pext_u64(code, morton_mask3 << 2))};
+#else
+	return {morton_compact3(code), morton_compact3(code >> 1), morton_compact3(code >> 2)};
+#endif
+}
+
+/* Morton codes for signed points, relative to an origin (usually the
+ * bounding box minimum). shift drops low bits from every axis so larger
+ * spans fit in 32 (2D) or 21 (3D) bits. */
+inline uint64_t morton_key(const point_t& p, const point_t& origin, unsigned shift = 0) {
+	return morton_encode(static_cast<uint32_t>(static_cast<uint64_t>(p.x - origin.x) >> shift),
+						 static_cast<uint32_t>(static_cast<uint64_t>(p.y - origin.y) >> shift));
+}
+
+inline uint64_t morton_key3(const point_t& p, const point_t& origin, unsigned shift = 0) {
+	return morton_encode(static_cast<uint32_t>(static_cast<uint64_t>(p.x - origin.x) >> shift),
+						 static_cast<uint32_t>(static_cast<uint64_t>(p.y - origin.y) >> shift),
+						 static_cast<uint32_t>(static_cast<uint64_t>(p.z - origin.z) >> shift));
+}
+
+/* The order (indices into points) that puts points in Z-order.
+ * Dims is 2 (x, y) or 3 (x, y, z). Works on anything with size() and
+ * operator[] giving a point_t or point<N, T>, including point_cloud_t. */
+template <size_t Dims = 2, typename C>
+std::vector<size_t> morton_order(const C& points) {
+	static_assert(Dims == 2 || Dims == 3, "morton order is 2D or 3D");
+
+	std::vector<size_t> order(points.size());
+	if (points.size() == 0) {
+		return order;
+	}
+
+	// bounding box, so coordinates can be made unsigned and scaled to fit
+	point_t lo = points[0];
+	point_t hi = points[0];
+	for (size_t i = 1; i < points.size(); i++) {
+		point_t p = points[i];
+		lo = {std::min(lo.x, p.x), std::min(lo.y, p.y), std::min(lo.z, p.z)};
+		hi = {std::max(hi.x, p.x), std::max(hi.y, p.y), std::max(hi.z, p.z)};
+	}
+
+	uint64_t span = static_cast<uint64_t>(std::max(hi.x - lo.x, hi.y - lo.y));
+	if constexpr (Dims == 3) {
+		span = std::max(span, static_cast<uint64_t>(hi.z - lo.z));
+	}
+
+	constexpr unsigned bits = Dims == 2 ? 32 : 21;
+	unsigned shift = 0;
+	while ((span >> shift) >= (uint64_t{1} << bits)) {
+		shift++;
+	}
+
+	std::vector<std::pair<uint64_t, size_t>> keys(points.size());
+	for (size_t i = 0; i < points.size(); i++) {
+		point_t p = points[i];
+		keys[i] = {Dims == 2 ? morton_key(p, lo, shift) : morton_key3(p, lo, shift), i};
+	}
+
+	std::sort(keys.begin(), keys.end());
+
+	for (size_t i = 0; i < keys.size(); i++) {
+		order[i] = keys[i].second;
+	}
+	return order;
+}
+
+/* Reorder a container of points (vector<point_t>, vector<point3i_t>...) into Z-order. */
+template <size_t Dims = 2, typename C>
+void morton_sort(C& points) {
+	auto order = morton_order<Dims>(points);
+
+	C sorted;
+	sorted.reserve(points.size());
+	for (size_t i : order) {
+		sorted.push_back(points[i]);
+	}
+	points = std::move(sorted);
+}
+
+#endif
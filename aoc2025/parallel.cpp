@@ -0,0 +1,102 @@
+#include "parallel.h"
+
+#include <algorithm>  // min, max
+
+thread_pool_t::thread_pool_t(size_t threads) {
+	for (size_t i = 1; i < std::max<size_t>(threads, 1); i++) {
+		_workers.emplace_back(&thread_pool_t::worker, this, i);
+	}
+}
+
+thread_pool_t::~thread_pool_t() {
+	{
+		std::lock_guard lock(_mutex);
+		_stopping = true;
+	}
+	_wake.notify_all();
+
+	for (auto& worker : _workers) {
+		worker.join();
+	}
+}
+
+thread_pool_t& thread_pool_t::shared() {
+	static thread_pool_t pool;
+	return pool;
+}
+
+void thread_pool_t::worker(size_t thread_index) {
+	size_t seen = 0;
+	while (true) {
+		const std::function<void(size_t)>* job = nullptr;
+		{
+			std::unique_lock lock(_mutex);
+			_wake.wait(lock, [&]() { return _stopping || _generation != seen; });
+			if (_stopping) {
+				return;
+			}
+
+			seen = _generation;
+			job = _job;
+		}
+
+		(*job)(thread_index);
+
+		{
+			std::lock_guard lock(_mutex);
+			if (--_running == 0) {
+				_done.notify_one();
+			}
+		}
+	}
+}
+
+void thread_pool_t::run_on_all(const std::function<void(size_t thread_index)>& fn) {
+	{
+		std::unique_lock lock(_mutex);
+		if (_busy || _workers.empty()) {
+			// nested, another caller's loop, or no workers; every index runs
+			// here in turn so loops split by size() still cover everything
+			lock.unlock();
+			for (size_t t = 0; t < size(); t++) {
+				fn(t);
+			}
+			return;
+		}
+
+		_busy = true;
+		_job = &fn;
+		_running = _workers.size();
+		++_generation;
+	}
+	_wake.notify_all();
+
+	fn(0);
+
+	std::unique_lock lock(_mutex);
+	_done.wait(lock, [&]() { return _running == 0; });
+	_job = nullptr;
+	_busy = false;
+}
+
+void thread_pool_t::parallel_for(size_t n, const std::function<void(size_t begin, size_t end)>& fn, size_t grain) {
+	if (n == 0) {
+		return;
+	}
+
+	if (grain == 0) {
+		grain = std::max<size_t>(1, n / (size() * 8));
+	}
+
+	if (size() == 1 || n <= grain) {
+		fn(0, n);
+		return;
+	}
+
+	std::atomic<size_t> next = 0;
+	run_on_all([&](size_t) {
+		for (size_t begin = next.fetch_add(grain); begin < n; begin = next.fetch_add(grain)) {
+			fn(begin, std::min(begin + grain, n));
+		}
+	});
+}
@@ -0,0 +1,138 @@
+#if !defined(POINT_CLOUD_T_H)
+#define POINT_CLOUD_T_H
+
+#include <algorithm>  // min, max
+#include <cstddef>
+#include <cstdint>
+#include <new>	// align_val_t
+#include <span>
+#include <utility>
+#include <vector>
+
+#include "point.h"
+
+/* Allocator for vectors whose data has to start on a cache line (or SIMD
+ * register) boundary. */
+template <typename T, size_t Alignment = 64>
+struct aligned_allocator {
+	using value_type = T;
+
+	template <typename U>
+	struct rebind {
+		using other = aligned_allocator<U, Alignment>;
+	};
+
+	aligned_allocator() = default;
+
+	template <typename U>
+	aligned_allocator(const aligned_allocator<U, Alignment>&) {}
+
+	T* allocate(size_t n) {
+		return static_cast<T*>(::operator new(n * sizeof(T), std::align_val_t{Alignment}));
+	}
+
+	void deallocate(T* p, size_t) {
+		::operator delete(p, std::align_val_t{Alignment});
+	}
+
+	template <typename U>
+	bool operator==(const aligned_allocator<U, Alignment>&) const { return true; }
+};
+
+template <typename T>
+using aligned_vector = std::vector<T, aligned_allocator<T>>;
+
+/* 3D points stored as a structure of arrays; all the x, then all the y, then all the z.
+ *
+ * Built for the O(n^2) "distance between every pair" loops (day 8) where a
+ * vector of point_t pointers spends its time chasing pointers. The kernels
+ * below run straight down the arrays so the compiler can vectorize them
+ * (and use AVX2 directly when built with -mavx2 or -march=native).
+ *
+ * Coordinates are int32_t and must stay within +/-2^30, so a difference fits
+ * in 32 bits and a squared distance fits in uint64_t.
+ */
+struct point_cloud_t {
+	using coordinate_t = int32_t;
+	using distance_t = uint64_t;
+
+	aligned_vector<coordinate_t> x = {};
+	aligned_vector<coordinate_t> y = {};
+	aligned_vector<coordinate_t> z = {};
+
+	point_cloud_t() {}
+
+	template <typename T>
+	static point_cloud_t from_points(const T& points) {
+		point_cloud_t cloud;
+		cloud.reserve(points.size());
+		for (const auto& p : points) {
+			cloud.push_back(p);
+		}
+		return cloud;
+	}
+
+	size_t size() const { return x.size(); }
+	bool empty() const { return x.empty(); }
+
+	void reserve(size_t n) {
+		x.reserve(n);
+		y.reserve(n);
+		z.reserve(n);
+	}
+
+	void clear() {
+		x.clear();
+		y.clear();
+		z.clear();
+	}
+
+	void push_back(const point3i_t& p) {
+		x.push_back(p.x);
+		y.push_back(p.y);
+		z.push_back(p.z);
+	}
+
+	void push_back(const point_t& p) {
+		push_back(point3i_t(p));
+	}
+
+	point3i_t operator[](size_t i) const {
+		return {x[i], y[i], z[i]};
+	}
+
+	/* Squared distance from p to every point, out[i] = |cloud[i] - p|^2.
+	 * out must hold size() entries. */
+	void sq_distances(const point3i_t& p, std::span<distance_t> out) const;
+
+	/* Squared distances for the block of pairs rows [i0, i1) x columns [j0, j1),
+	 * row-major: out[(i - i0) * (j1 - j0) + (j - j0)] = |cloud[i] - cloud[j]|^2 */
+	void sq_distance_tile(size_t i0, size_t i1, size_t j0, size_t j1, std::span<distance_t> out) const;
+
+	/* Smallest and largest coordinate on each axis; {min, max} (inclusive). */
+	std::pair<point3i_t, point3i_t> bounding_box() const;
+
+	/* Call fn(i, j, sq_distance) for every pair i < j, one tile at a time so
+	 * the distance buffer and both runs of coordinates stay in cache. */
+	template <typename F>
+	void for_each_pair(F&& fn, size_t tile = 64) const {
+		std::vector<distance_t> buffer(tile * tile);
+		for (size_t i0 = 0; i0 < size(); i0 += tile) {
+			size_t i1 = std::min(i0 + tile, size());
+			for (size_t j0 = i0; j0 < size(); j0 += tile) {
+				size_t j1 = std::min(j0 + tile, size());
+				size_t width = j1 - j0;
+				sq_distance_tile(i0, i1, j0, j1, buffer);
+
+				for (size_t i = i0; i < i1; i++) {
+					const distance_t* row = &buffer[(i - i0) * width];
+					for (size_t j = std::max(j0, i + 1); j < j1; j++) {
+						fn(i, j, row[j - j0]);
+					}
+				}
+			}
+		}
+	}
+};
+
+#endif
@@ -0,0 +1,96 @@
+#if !defined(POINT_PARSER_H)
+#define POINT_PARSER_H
+
+#include <algorithm>  // min
+#include <cstddef>
+#include <string_view>
+
+#include "point.h"
+
+/* Streaming point parser; one point per line ("1,2", "-3,4,5", "p=1,2,3,4"...)
+ * scanned straight out of a buffer (see mapped_file_t) with no getline, no
+ * substr and no per-line allocation.
+ *
+ * Like read_points(), parsing stops at an empty line. The rest of the text
+ * (after that empty line) is returned so the next section can be parsed.
+ *
+ *	mapped_file_t file(filename);
+ *	point_cloud_t boxes;
+ *	parse_points(file.view(), boxes);
+ *
+ *	std::vector<point2i_t> tiles;
+ *	auto rest = parse_points(text, tiles);
+ */
+
+/* Call fn(const value_t* values, size_t count) for each line up to an empty
+ * line; count is how many numbers (at most 4) were on the line. */
+template <typename F>
+std::string_view for_each_point_line(std::string_view text, F&& fn) {
+	size_t pos = 0;
+	while (pos < text.size()) {
+		size_t eol = text.find('\n', pos);
+		if (eol == std::string_view::npos) {
+			eol = text.size();
+		}
+
+		std::string_view line = text.substr(pos, eol - pos);
+		if (!line.empty() && line.back() == '\r') {
+			line.remove_suffix(1);
+		}
+
+		pos = eol + 1;
+		if (line.empty()) {
+			return text.substr(std::min(pos, text.size()));
+		}
+
+		value_t values[4] = {0, 0, 0, 0};
+		size_t count = scan_integers(line, values, 4);
+		fn(values, count);
+	}
+
+	return {};
+}
+
+/* Lines before the first empty one; as many as for_each_point_line() visits. */
+inline size_t count_section_lines(std::string_view text) {
+	size_t lines = 0;
+	size_t pos = 0;
+	while (pos < text.size()) {
+		size_t eol = text.find('\n', pos);
+		if (eol == std::string_view::npos) {
+			return lines + 1;
+		}
+		if (eol == pos || (eol == pos + 1 && text[pos] == '\r')) {
+			return lines;
+		}
+
+		lines++;
+		pos = eol + 1;
+	}
+	return lines;
+}
+
+/* Append the points in text to out; any container with push_back or
+ * emplace_back of point_t (vector<point_t>, vector<point<N, T>>,
+ * point_cloud_t). Reserves once up front for the lines in this section
+ * (not the ones after an empty line, which are left for the next call). Lines
+ * with no numbers on them are skipped rather than read as the origin. */
+template <typename C>
+std::string_view parse_points(std::string_view text, C& out) {
+	out.reserve(out.size() + count_section_lines(text));
+
+	return for_each_point_line(text, [&out](const value_t* v, size_t count) {
+		if (count == 0) {
+			return;
+		}
+
+		point_t p{v[0], v[1], v[2], v[3]};
+		if constexpr (requires { out.emplace_back(p); }) {
+			out.emplace_back(p);
+		} else {
+			out.push_back(p);
+		}
+	});
+}
+
+#endif
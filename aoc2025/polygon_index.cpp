@@ -0,0 +1,251 @@
+#include "polygon_index.h"
+
+#include <algorithm>  // sort, merge, lower_bound, upper_bound
+#include <cassert>
+#include <limits>
+
+void polygon_index_t::edge_set_t::build(std::vector<std::pair<dimension_t, std::pair<dimension_t, dimension_t>>>& edges) {
+	std::sort(edges.begin(), edges.end());
+
+	const size_t n = edges.size();
+	keys.clear();
+	by_lo.clear();
+	hi_max.clear();
+	by_hi.clear();
+	if (n == 0) {
+		return;
+	}
+
+	size_t levels = 1;
+	while ((size_t{1} << (levels - 1)) < n) {
+		levels++;
+	}
+
+	by_lo.assign(levels, std::vector<std::pair<dimension_t, dimension_t>>(n));
+	hi_max.assign(levels, std::vector<dimension_t>(n));
+	by_hi.assign(levels, std::vector<dimension_t>(n));
+
+	keys.reserve(n);
+	for (size_t i = 0; i < n; i++) {
+		keys.push_back(edges[i].first);
+		by_lo[0][i] = edges[i].second;
+		hi_max[0][i] = edges[i].second.second;
+		by_hi[0][i] = edges[i].second.second;
+	}
+
+	// each level merges pairs of blocks from the one below
+	for (size_t d = 1; d < levels; d++) {
+		const size_t width = size_t{1} << d;
+		for (size_t start = 0; start < n; start += width) {
+			const auto mid = static_cast<std::ptrdiff_t>(std::min(start + width / 2, n));
+			const auto stop = static_cast<std::ptrdiff_t>(std::min(start + width, n));
+			const auto first = static_cast<std::ptrdiff_t>(start);
+
+			const auto& lo_below = by_lo[d - 1];
+			std::merge(lo_below.begin() + first, lo_below.begin() + mid,
+					   lo_below.begin() + mid, lo_below.begin() + stop,
+					   by_lo[d].begin() + first);
+
+			const auto& hi_below = by_hi[d - 1];
+			std::merge(hi_below.begin() + first, hi_below.begin() + mid,
+					   hi_below.begin() + mid, hi_below.begin() + stop,
+					   by_hi[d].begin() + first);
+
+			dimension_t running = by_lo[d][start].second;
+			for (size_t i = start; i < static_cast<size_t>(stop); i++) {
+				running = std::max(running, by_lo[d][i].second);
+				hi_max[d][i] = running;
+			}
+		}
+	}
+}
+
+/* Call fn(level, start, stop) for the O(log n) blocks that exactly cover
+ * [begin, end); stops early when fn returns true. */
+template <typename F>
+void polygon_index_t::edge_set_t::visit(size_t begin, size_t end, F&& fn) const {
+	if (begin >= end) {
+		return;
+	}
+
+	auto walk = [&](auto& self, size_t d, size_t start) -> bool {
+		const size_t stop = std::min(start + (size_t{1} << d), size());
+		if (stop <= begin || end <= start) {
+			return false;
+		}
+
+		if (begin <= start && stop <= end) {
+			return fn(d, start, stop);
+		}
+
+		// only partly covered, so d > 0
+		const size_t half = size_t{1} << (d - 1);
+		return self(self, d - 1, start) || self(self, d - 1, start + half);
+	};
+
+	walk(walk, by_lo.size() - 1, 0);
+}
+
+bool polygon_index_t::edge_set_t::any_overlap(size_t begin, size_t end, dimension_t a, dimension_t b) const {
+	bool found = false;
+	visit(begin, end, [&](size_t d, size_t start, size_t stop) {
+		const auto first = by_lo[d].begin() + static_cast<std::ptrdiff_t>(start);
+		const auto last = by_lo[d].begin() + static_cast<std::ptrdiff_t>(stop);
+
+		// edges starting before b, then the furthest any of them reaches
+		auto k = std::lower_bound(first, last, b, [](const auto& edge, dimension_t v) { return edge.first < v; });
+		if (k != first && hi_max[d][start + static_cast<size_t>(k - first) - 1] > a) {
+			found = true;
+		}
+		return found;
+	});
+	return found;
+}
+
+size_t polygon_index_t::edge_set_t::stab_count(size_t begin, size_t end, dimension_t v) const {
+	size_t count = 0;
+	visit(begin, end, [&](size_t d, size_t start, size_t stop) {
+		const auto lo_first = by_lo[d].begin() + static_cast<std::ptrdiff_t>(start);
+		const auto lo_last = by_lo[d].begin() + static_cast<std::ptrdiff_t>(stop);
+		const auto hi_first = by_hi[d].begin() + static_cast<std::ptrdiff_t>(start);
+		const auto hi_last = by_hi[d].begin() + static_cast<std::ptrdiff_t>(stop);
+
+		// started at or before v, less those that also ended at or before v
+		auto started = std::upper_bound(lo_first, lo_last, v, [](dimension_t x, const auto& edge) { return x < edge.first; }) - lo_first;
+		auto ended = std::upper_bound(hi_first, hi_last, v) - hi_first;
+		count += static_cast<size_t>(started - ended);
+		return false;
+	});
+	return count;
+}
+
+std::pair<size_t, size_t> polygon_index_t::edge_set_t::open_range(dimension_t a, dimension_t b) const {
+	auto begin = static_cast<size_t>(std::upper_bound(keys.begin(), keys.end(), a) - keys.begin());
+	auto end = static_cast<size_t>(std::lower_bound(keys.begin(), keys.end(), b) - keys.begin());
+	return {begin, std::max(begin, end)};
+}
+
+std::pair<size_t, size_t> polygon_index_t::edge_set_t::closed_range(dimension_t a, dimension_t b) const {
+	auto begin = static_cast<size_t>(std::lower_bound(keys.begin(), keys.end(), a) - keys.begin());
+	auto end = static_cast<size_t>(std::upper_bound(keys.begin(), keys.end(), b) - keys.begin());
+	return {begin, std::max(begin, end)};
+}
+
+void polygon_index_t::build(const std::vector<std::pair<dimension_t, dimension_t>>& vertices) {
+	std::vector<std::pair<dimension_t, std::pair<dimension_t, dimension_t>>> horizontal;
+	std::vector<std::pair<dimension_t, std::pair<dimension_t, dimension_t>>> vertical;
+
+	for (size_t i = 0; i < vertices.size(); i++) {
+		const auto [ax, ay] = vertices[i];
+		const auto [bx, by] = vertices[(i + 1) % vertices.size()];
+
+		if (ay == by && ax != bx) {
+			horizontal.push_back({2 * ay, {2 * std::min(ax, bx), 2 * std::max(ax, bx)}});
+		} else if (ax == bx && ay != by) {
+			vertical.push_back({2 * ax, {2 * std::min(ay, by), 2 * std::max(ay, by)}});
+		} else {
+			// repeated vertex is fine, diagonal edge is not
+			assert(ax == bx && ay == by);
+		}
+	}
+
+	_horizontal.build(horizontal);
+	_vertical.build(vertical);
+}
+
+bool polygon_index_t::on_boundary_doubled(dimension_t x, dimension_t y) const {
+	auto [h_begin, h_end] = _horizontal.closed_range(y, y);
+	if (_horizontal.any_overlap(h_begin, h_end, x - 1, x + 1)) {
+		return true;
+	}
+
+	auto [v_begin, v_end] = _vertical.closed_range(x, x);
+	return _vertical.any_overlap(v_begin, v_end, y - 1, y + 1);
+}
+
+bool polygon_index_t::contains_doubled(dimension_t x, dimension_t y) const {
+	if (on_boundary_doubled(x, y)) {
+		return true;
+	}
+
+	// cast a ray towards +x; odd number of vertical edges crossed is inside
+	auto [begin, end] = _vertical.closed_range(x + 1, std::numeric_limits<dimension_t>::max());
+	return _vertical.stab_count(begin, end, y) % 2 == 1;
+}
+
+bool polygon_index_t::crosses_doubled(dimension_t x1, dimension_t y1, dimension_t x2, dimension_t y2) const {
+	auto [h_begin, h_end] = _horizontal.open_range(y1, y2);
+	if (_horizontal.any_overlap(h_begin, h_end, x1, x2)) {
+		return true;
+	}
+
+	auto [v_begin, v_end] = _vertical.open_range(x1, x2);
+	return _vertical.any_overlap(v_begin, v_end, y1, y2);
+}
+
+bool polygon_index_t::crosses(dimension_t x1, dimension_t y1, dimension_t x2, dimension_t y2) const {
+	return crosses_doubled(2 * std::min(x1, x2), 2 * std::min(y1, y2),
+						   2 * std::max(x1, x2), 2 * std::max(y1, y2));
+}
+
+/* Does the segment from a1 to a2 at c (doubled, a1 < a2) pass outside the
+ * polygon between its ends? across holds the edges perpendicular to it.
+ *
+ * Just either side of the segment (c - 1 and c + 1) no edge runs along it, so
+ * inside/outside there only changes at an edge's key. The segment is outside
+ * exactly where both sides are. Start from the ray parity just past a1 and
+ * flip at each edge key up to a2. */
+bool polygon_index_t::segment_leaves(const edge_set_t& across, dimension_t a1, dimension_t a2, dimension_t c) const {
+	const dimension_t max = std::numeric_limits<dimension_t>::max();
+
+	auto [begin, end] = across.closed_range(a1 + 1, max);
+	bool above = across.stab_count(begin, end, c + 1) % 2 == 1;
+	bool below = across.stab_count(begin, end, c - 1) % 2 == 1;
+
+	// level 0 of the tree is the edges in key order
+	for (size_t i = begin; i < end && across.keys[i] < a2;) {
+		if (!above && !below) {
+			return true;
+		}
+
+		const dimension_t key = across.keys[i];
+		for (; i < end && across.keys[i] == key; i++) {
+			const auto [lo, hi] = across.by_lo[0][i];
+			above ^= (lo <= c + 1 && c + 1 < hi);
+			below ^= (lo <= c - 1 && c - 1 < hi);
+		}
+	}
+
+	return !above && !below;
+}
+
+bool polygon_index_t::contains_box(dimension_t x1, dimension_t y1, dimension_t x2, dimension_t y2) const {
+	const dimension_t lo_x = 2 * std::min(x1, x2);
+	const dimension_t lo_y = 2 * std::min(y1, y2);
+	const dimension_t hi_x = 2 * std::max(x1, x2);
+	const dimension_t hi_y = 2 * std::max(y1, y2);
+
+	if (lo_x == hi_x || lo_y == hi_y) {
+		// no interior, a single point or row or column
+		if (!contains_doubled(lo_x, lo_y) || !contains_doubled(hi_x, hi_y)) {
+			return false;
+		}
+
+		if (lo_y == hi_y && lo_x != hi_x) {
+			return !segment_leaves(_vertical, lo_x, hi_x, lo_y);
+		}
+
+		if (lo_x == hi_x && lo_y != hi_y) {
+			return !segment_leaves(_horizontal, lo_y, hi_y, lo_x);
+		}
+
+		return true;
+	}
+
+	// no edge inside means the whole box is on one side; its centre says which
+	if (crosses_doubled(lo_x, lo_y, hi_x, hi_y)) {
+		return false;
+	}
+
+	return contains_doubled((lo_x + hi_x) / 2, (lo_y + hi_y) / 2);
+}
@@ -0,0 +1,116 @@
+#if !defined(POLYGON_INDEX_H)
+#define POLYGON_INDEX_H
+
+#include <cstddef>
+#include <utility>	// std::pair
+#include <vector>
+
+#include "point.h"
+
+/* Point-in-polygon and box crossing queries against a rectilinear polygon
+ * (every edge horizontal or vertical, e.g. day 9's tiles) in O(log^2 n)
+ * instead of walking every edge.
+ *
+ * Horizontal edges are kept sorted by y and vertical edges by x, each with
+ * a merge sort tree over them: every node of the tree holds the span of
+ * its edges sorted by start, with a running max of their ends, and sorted
+ * by end. A query picks the range of edges by y (or x) with a binary search,
+ * splits it into O(log n) nodes and does one more binary search in each.
+ *
+ * Coordinates are doubled internally so the centre of any box is a lattice
+ * point and tests on it stay exact. The polygon's boundary counts as inside.
+ *
+ *	polygon_index_t index(tiles);
+ *	index.contains(7, 3);
+ *	index.contains_box(2, 3, 9, 5);		// every point of [2,9] x [3,5] inside
+ */
+class polygon_index_t {
+   public:
+	polygon_index_t() {}
+
+	/* Build from the polygon's vertices in order (either winding); anything
+	 * with .x and .y, e.g. vector<point_t> or vector<point2i_t>. */
+	template <typename C>
+	explicit polygon_index_t(const C& polygon) {
+		std::vector<std::pair<dimension_t, dimension_t>> vertices;
+		vertices.reserve(polygon.size());
+		for (const auto& p : polygon) {
+			vertices.emplace_back(static_cast<dimension_t>(p.x), static_cast<dimension_t>(p.y));
+		}
+		build(vertices);
+	}
+
+	size_t size() const { return _horizontal.size() + _vertical.size(); }
+
+	/* (x, y) is inside the polygon or on its boundary */
+	bool contains(dimension_t x, dimension_t y) const {
+		return contains_doubled(2 * x, 2 * y);
+	}
+
+	/* (x, y) is on one of the polygon's edges */
+	bool on_boundary(dimension_t x, dimension_t y) const {
+		return on_boundary_doubled(2 * x, 2 * y);
+	}
+
+	/* Some edge passes through the open interior of [x1, x2] x [y1, y2];
+	 * touching the box's sides or corners does not count. */
+	bool crosses(dimension_t x1, dimension_t y1, dimension_t x2, dimension_t y2) const;
+
+	/* Every point of [x1, x2] x [y1, y2] is inside or on the polygon. A box
+	 * a single row or column thick also walks the edges touching it. */
+	bool contains_box(dimension_t x1, dimension_t y1, dimension_t x2, dimension_t y2) const;
+
+	template <typename P>
+	bool contains(const P& p) const {
+		return contains(static_cast<dimension_t>(p.x), static_cast<dimension_t>(p.y));
+	}
+
+	template <typename P>
+	bool contains_box(const P& a, const P& b) const {
+		return contains_box(static_cast<dimension_t>(a.x), static_cast<dimension_t>(a.y),
+							static_cast<dimension_t>(b.x), static_cast<dimension_t>(b.y));
+	}
+
+   private:
+	/* Axis-aligned edges at a fixed key (y for horizontal, x for vertical)
+	 * spanning [lo, hi] on the other axis, with the merge sort tree. */
+	struct edge_set_t {
+		std::vector<dimension_t> keys = {};	 // sorted
+
+		// per level d, blocks of 2^d edges (in key order) each sorted by lo / hi
+		std::vector<std::vector<std::pair<dimension_t, dimension_t>>> by_lo = {};  // (lo, hi)
+		std::vector<std::vector<dimension_t>> hi_max = {};	// running max of hi within the block, by_lo order
+		std::vector<std::vector<dimension_t>> by_hi = {};
+
+		size_t size() const { return keys.size(); }
+
+		// edges are (key, lo, hi) with lo < hi
+		void build(std::vector<std::pair<dimension_t, std::pair<dimension_t, dimension_t>>>& edges);
+
+		// some edge in [begin, end) (key order) has lo < b and hi > a
+		bool any_overlap(size_t begin, size_t end, dimension_t a, dimension_t b) const;
+
+		// number of edges in [begin, end) with lo <= v < hi
+		size_t stab_count(size_t begin, size_t end, dimension_t v) const;
+
+		// index range of edges with key in the open range (a, b) or closed [a, b]
+		std::pair<size_t, size_t> open_range(dimension_t a, dimension_t b) const;
+		std::pair<size_t, size_t> closed_range(dimension_t a, dimension_t b) const;
+
+	   private:
+		template <typename F>
+		void visit(size_t begin, size_t end, F&& fn) const;
+	};
+
+	edge_set_t _horizontal = {};  // keyed by y, spanning x
+	edge_set_t _vertical = {};	  // keyed by x, spanning y
+
+	void build(const std::vector<std::pair<dimension_t, dimension_t>>& vertices);
+
+	bool contains_doubled(dimension_t x, dimension_t y) const;
+	bool on_boundary_doubled(dimension_t x, dimension_t y) const;
+	bool crosses_doubled(dimension_t x1, dimension_t y1, dimension_t x2, dimension_t y2) const;
+	bool segment_leaves(const edge_set_t& across, dimension_t a1, dimension_t a2, dimension_t c) const;
+};
+
+#endif
@@ -0,0 +1,166 @@
+#if !defined(PRIORITY_QUEUE_H)
+#define PRIORITY_QUEUE_H
+
+#include <algorithm>  // min, push_heap, pop_heap
+#include <array>
+#include <bit>	// bit_width
+#include <cassert>
+#include <cstddef>
+#include <utility>	// std::pair
+#include <vector>
+
+/* Min priority queues of (key, value) for Dijkstra style searches.
+ *
+ *	binary_queue_t	binary heap; any keys, O(log n)
+ *	dial_queue_t	buckets by key mod (max_weight + 1); O(1), keys pushed
+ *					at most max_weight above the last popped
+ *	radix_heap_t	buckets by highest bit differing from the last popped;
+ *					O(log C) amortized, keys never below the last popped
+ *
+ * The last two are monotone: a key pushed is never less than the key last
+ * popped, which holds for Dijkstra with non-negative weights. All share
+ * push(key, value), pop() -> {key, value}, empty(), size() and bytes()
+ * (memory held).
+ */
+enum class queue_kind_t {
+	automatic,	// dial_queue_t if the max weight is known and small, else radix_heap_t
+	binary,
+	dial,
+	radix,
+};
+
+/* Largest max weight automatic picks dial_queue_t for. */
+constexpr size_t dial_queue_limit = 1 << 16;
+
+template <typename Value>
+class binary_queue_t {
+   public:
+	using entry_t = std::pair<size_t, Value>;
+
+	void push(size_t key, const Value& value) {
+		_heap.push_back({key, value});
+		std::push_heap(_heap.begin(), _heap.end(), later);
+	}
+
+	entry_t pop() {
+		std::pop_heap(_heap.begin(), _heap.end(), later);
+		entry_t top = _heap.back();
+		_heap.pop_back();
+		return top;
+	}
+
+	bool empty() const { return _heap.empty(); }
+	size_t size() const { return _heap.size(); }
+	size_t bytes() const { return _heap.capacity() * sizeof(entry_t); }
+
+   private:
+	// a heap by hand rather than std::priority_queue, so bytes() can see the capacity
+	std::vector<entry_t> _heap = {};
+
+	// by key alone, so Value needs no ordering
+	static bool later(const entry_t& a, const entry_t& b) { return a.first > b.first; }
+};
+
+template <typename Value>
+class dial_queue_t {
+   public:
+	using entry_t = std::pair<size_t, Value>;
+
+	dial_queue_t(size_t max_weight) : _buckets(max_weight + 1) {
+	}
+
+	void push(size_t key, const Value& value) {
+		assert(key >= _current && key - _current < _buckets.size());
+		_buckets[key % _buckets.size()].push_back(value);
+		_size++;
+	}
+
+	entry_t pop() {
+		assert(_size > 0);
+		while (_buckets[_current % _buckets.size()].empty()) {
+			_current++;
+		}
+
+		auto& bucket = _buckets[_current % _buckets.size()];
+		Value value = bucket.back();
+		bucket.pop_back();
+		_size--;
+		return {_current, value};
+	}
+
+	bool empty() const { return _size == 0; }
+	size_t size() const { return _size; }
+
+	size_t bytes() const {
+		size_t bytes = _buckets.capacity() * sizeof(_buckets[0]);
+		for (const auto& bucket : _buckets) {
+			bytes += bucket.capacity() * sizeof(Value);
+		}
+		return bytes;
+	}
+
+   private:
+	std::vector<std::vector<Value>> _buckets;
+	size_t _current = 0;  // key of the bucket last popped
+	size_t _size = 0;
+};
+
+template <typename Value>
+class radix_heap_t {
+   public:
+	using entry_t = std::pair<size_t, Value>;
+
+	void push(size_t key, const Value& value) {
+		assert(key >= _last);
+		_buckets[bucket_of(key)].push_back({key, value});
+		_size++;
+	}
+
+	entry_t pop() {
+		assert(_size > 0);
+		if (_buckets[0].empty()) {
+			// the smallest key in the first non-empty bucket becomes last;
+			// everything else in it moves to a lower bucket
+			size_t i = 1;
+			while (_buckets[i].empty()) {
+				i++;
+			}
+
+			_last = _buckets[i][0].first;
+			for (const auto& entry : _buckets[i]) {
+				_last = std::min(_last, entry.first);
+			}
+			for (const auto& entry : _buckets[i]) {
+				_buckets[bucket_of(entry.first)].push_back(entry);
+			}
+			_buckets[i].clear();
+		}
+
+		entry_t entry = _buckets[0].back();
+		_buckets[0].pop_back();
+		_size--;
+		return entry;
+	}
+
+	bool empty() const { return _size == 0; }
+	size_t size() const { return _size; }
+
+	size_t bytes() const {
+		size_t bytes = sizeof(_buckets);
+		for (const auto& bucket : _buckets) {
+			bytes += bucket.capacity() * sizeof(entry_t);
+		}
+		return bytes;
+	}
+
+   private:
+	std::array<std::vector<entry_t>, 65> _buckets = {};
+	size_t _last = 0;
+	size_t _size = 0;
+
+	size_t bucket_of(size_t key) const {
+		return static_cast<size_t>(std::bit_width(key ^ _last));
+	}
+};
+
+#endif
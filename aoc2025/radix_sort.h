@@ -0,0 +1,371 @@
+#if !defined(RADIX_SORT_H)
+#define RADIX_SORT_H
+
+#include <algorithm>  // copy, min
+#include <array>
+#include <bit>  // bit_width
+#include <concepts>
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include <type_traits>
+#include <utility>	// std::pair
+#include <vector>
+
+#include "parallel.h"
+
+/* LSD radix sorts; 11 bits per pass, stable, O(n) per pass.
+ *
+ * Every sort here is radix_sort_by(items, keys...): keys are functions
+ * from an item to an integer (signed or not, up to 64 bits), most
+ * significant first. Keys are sorted less their smallest value, so only
+ * the bits that vary cost passes (-5..5 in an int64_t is one pass, the
+ * z of 2D points none). Several keys that fit in 64 bits together are
+ * packed and sorted as one.
+ *
+ *	radix_sort(values);										// integers
+ *	radix_sort_by_first(pairs);								// pair<key, payload>
+ *	radix_sort_points(points);								// x, y, z, w like point_t::operator<
+ *	radix_sort_by(edges, [](const edge_t& e) { return e.cost; });
+ *	parallel_radix_sort_by(big, pool, key);					// same, across threads
+ */
+
+/* Map an integer to an unsigned one with the same order. */
+template <std::integral T>
+constexpr std::make_unsigned_t<T> radix_key(T value) {
+	using U = std::make_unsigned_t<T>;
+	if constexpr (std::is_signed_v<T>) {
+		return static_cast<U>(static_cast<U>(value) ^ (U{1} << (sizeof(T) * 8 - 1)));
+	} else {
+		return value;
+	}
+}
+
+namespace radix_detail {
+
+constexpr size_t radix_bits = 11;  // six passes for 64 bits, histograms in L1
+constexpr size_t buckets = size_t{1} << radix_bits;
+
+using histogram_t = std::array<size_t, buckets>;
+
+template <typename U>
+constexpr size_t digit(U key, size_t pass) {
+	return static_cast<size_t>((key >> (pass * radix_bits)) & (buckets - 1));
+}
+
+/* Passes needed for keys from lo to hi once lo is taken off. */
+template <typename U>
+constexpr size_t span_passes(U lo, U hi) {
+	size_t passes = 0;
+	for (U range = static_cast<U>(hi - lo); range != 0; range = static_cast<U>(range >> radix_bits)) {
+		passes++;
+	}
+	return passes;
+}
+
+/* Sort items by one key, using scratch (sized to match) as the other buffer. */
+template <typename T, typename Key>
+void sort_by_one(std::span<T> items, std::vector<T>& scratch, Key&& key) {
+	using U = decltype(radix_key(key(items[0])));
+	const size_t n = items.size();
+
+	// keys are sorted less their minimum, so -5..5 is one pass, not six
+	U lo = radix_key(key(items[0]));
+	U hi = lo;
+	for (const T& item : items) {
+		U k = radix_key(key(item));
+		lo = std::min(lo, k);
+		hi = std::max(hi, k);
+	}
+
+	const size_t passes = span_passes(lo, hi);
+	if (passes == 0) {
+		return;
+	}
+
+	auto rebased = [&](const T& item) { return static_cast<U>(radix_key(key(item)) - lo); };
+
+	// every pass's histogram in one read
+	std::vector<histogram_t> counts(passes);
+	for (const T& item : items) {
+		U k = rebased(item);
+		for (size_t pass = 0; pass < passes; pass++) {
+			counts[pass][digit(k, pass)]++;
+		}
+	}
+
+	if (scratch.size() != n) {
+		scratch.assign(items.begin(), items.end());	 // no default constructor needed
+	}
+	T* src = items.data();
+	T* dst = scratch.data();
+
+	for (size_t pass = 0; pass < passes; pass++) {
+		histogram_t& count = counts[pass];
+		if (count[digit(rebased(src[0]), pass)] == n) {
+			continue;  // all the same here
+		}
+
+		size_t offset = 0;
+		for (size_t& c : count) {
+			size_t here = c;
+			c = offset;
+			offset += here;
+		}
+
+		for (size_t i = 0; i < n; i++) {
+			dst[count[digit(rebased(src[i]), pass)]++] = src[i];
+		}
+		std::swap(src, dst);
+	}
+
+	if (src != items.data()) {
+		std::copy(src, src + n, items.data());
+	}
+}
+
+template <typename T, typename Key>
+void parallel_sort_by_one(std::span<T> items, std::vector<T>& scratch, thread_pool_t& pool, Key&& key) {
+	using U = decltype(radix_key(key(items[0])));
+	const size_t n = items.size();
+	const size_t chunks = pool.size();  // one per thread
+	const size_t chunk = (n + chunks - 1) / chunks;
+
+	auto begin_of = [&](size_t t) { return std::min(n, t * chunk); };
+	auto end_of = [&](size_t t) { return std::min(n, (t + 1) * chunk); };
+
+	// fn(t) once for each chunk t, on whichever threads are free; chunks
+	// rather than thread indexes, so a busy (nested) pool still does them all
+	auto for_each_chunk = [&](auto&& fn) {
+		pool.parallel_for(chunks, [&](size_t first, size_t last) {
+			for (size_t t = first; t < last; t++) {
+				fn(t);
+			}
+		}, 1);
+	};
+
+	std::vector<std::pair<U, U>> ranges(chunks, {radix_key(key(items[0])), radix_key(key(items[0]))});
+	for_each_chunk([&](size_t t) {
+		auto& [lo, hi] = ranges[t];
+		for (size_t i = begin_of(t); i < end_of(t); i++) {
+			U k = radix_key(key(items[i]));
+			lo = std::min(lo, k);
+			hi = std::max(hi, k);
+		}
+	});
+
+	U lo = ranges[0].first;
+	U hi = ranges[0].second;
+	for (const auto& [l, h] : ranges) {
+		lo = std::min(lo, l);
+		hi = std::max(hi, h);
+	}
+
+	const size_t passes = span_passes(lo, hi);
+	if (passes == 0) {
+		return;
+	}
+
+	auto rebased = [&](const T& item) { return static_cast<U>(radix_key(key(item)) - lo); };
+
+	if (scratch.size() != n) {
+		scratch.assign(items.begin(), items.end());	 // no default constructor needed
+	}
+	T* src = items.data();
+	T* dst = scratch.data();
+	std::vector<histogram_t> offsets(chunks);
+
+	for (size_t pass = 0; pass < passes; pass++) {
+		// each chunk is counted for this digit, as it now stands
+		for_each_chunk([&](size_t t) {
+			histogram_t& count = offsets[t];
+			count = {};
+			for (size_t i = begin_of(t); i < end_of(t); i++) {
+				count[digit(rebased(src[i]), pass)]++;
+			}
+		});
+
+		// bucket major, then chunk, so each chunk's items land in order
+		size_t offset = 0;
+		bool trivial = false;
+		for (size_t b = 0; b < buckets; b++) {
+			const size_t start = offset;
+			for (size_t t = 0; t < chunks; t++) {
+				size_t here = offsets[t][b];
+				offsets[t][b] = offset;
+				offset += here;
+			}
+			trivial = trivial || offset - start == n;
+		}
+		if (trivial) {
+			continue;  // all the same here
+		}
+
+		for_each_chunk([&](size_t t) {
+			histogram_t& count = offsets[t];
+			for (size_t i = begin_of(t); i < end_of(t); i++) {
+				dst[count[digit(rebased(src[i]), pass)]++] = src[i];
+			}
+		});
+		std::swap(src, dst);
+	}
+
+	if (src != items.data()) {
+		pool.parallel_for(n, [&](size_t begin, size_t end) {
+			std::copy(src + begin, src + end, items.data() + begin);
+		});
+	}
+}
+
+/* Several keys whose ranges fit in 64 bits together sort as one packed
+ * key with the item's index, then items move once; cheaper than a round
+ * of passes per key moving whole items. False if they don't fit. */
+template <typename T, typename... Keys>
+bool sort_packed(std::span<T> items, Keys&... keys) {
+	constexpr size_t count = sizeof...(Keys);
+	const size_t n = items.size();
+	if (n > UINT32_MAX) {
+		return false;
+	}
+
+	std::array<uint64_t, count> lo;
+	std::array<uint64_t, count> hi;
+	lo.fill(UINT64_MAX);
+	hi.fill(0);
+	for (const T& item : items) {
+		size_t i = 0;
+		((lo[i] = std::min(lo[i], static_cast<uint64_t>(radix_key(keys(item)))),
+		  hi[i] = std::max(hi[i], static_cast<uint64_t>(radix_key(keys(item)))), i++), ...);
+	}
+
+	std::array<size_t, count> bits{};
+	size_t total = 0;
+	for (size_t i = 0; i < count; i++) {
+		bits[i] = static_cast<size_t>(std::bit_width(hi[i] - lo[i]));
+		total += bits[i];
+	}
+	if (total > 64) {
+		return false;
+	}
+
+	std::vector<std::pair<uint64_t, uint32_t>> records;
+	records.reserve(n);
+	for (uint32_t index = 0; index < n; index++) {
+		uint64_t packed = 0;
+		size_t i = 0;
+		((packed = (bits[i] == 64 ? 0 : packed << bits[i]) | (static_cast<uint64_t>(radix_key(keys(items[index]))) - lo[i]), i++), ...);
+		records.emplace_back(packed, index);
+	}
+
+	std::vector<std::pair<uint64_t, uint32_t>> scratch;
+	sort_by_one(std::span(records), scratch, [](const std::pair<uint64_t, uint32_t>& r) { return r.first; });
+
+	std::vector<T> sorted;
+	sorted.reserve(n);
+	for (const auto& [packed, index] : records) {
+		sorted.push_back(items[index]);
+	}
+	std::move(sorted.begin(), sorted.end(), items.begin());
+	return true;
+}
+
+}  // namespace radix_detail
+
+/* Stable sort of items by keys (most significant first). */
+template <typename T, typename... Keys>
+void radix_sort_by(std::span<T> items, Keys&&... keys) {
+	if (items.size() < 2) {
+		return;
+	}
+
+	if constexpr (sizeof...(Keys) > 1) {
+		if (radix_detail::sort_packed(items, keys...)) {
+			return;
+		}
+	}
+
+	std::vector<T> scratch;
+	auto by_keys = std::forward_as_tuple(keys...);
+
+	// least significant key first
+	[&]<size_t... I>(std::index_sequence<I...>) {
+		(radix_detail::sort_by_one(items, scratch, std::get<sizeof...(Keys) - 1 - I>(by_keys)), ...);
+	}(std::index_sequence_for<Keys...>{});
+}
+
+template <typename T, typename... Keys>
+void radix_sort_by(std::vector<T>& items, Keys&&... keys) {
+	radix_sort_by(std::span<T>(items), std::forward<Keys>(keys)...);
+}
+
+/* As radix_sort_by, each pass split across the pool's threads. Worth it
+ * from a few hundred thousand items. */
+template <typename T, typename... Keys>
+void parallel_radix_sort_by(std::span<T> items, thread_pool_t& pool, Keys&&... keys) {
+	if (items.size() < 2) {
+		return;
+	}
+
+	std::vector<T> scratch;
+	auto by_keys = std::forward_as_tuple(keys...);
+
+	[&]<size_t... I>(std::index_sequence<I...>) {
+		(radix_detail::parallel_sort_by_one(items, scratch, pool, std::get<sizeof...(Keys) - 1 - I>(by_keys)), ...);
+	}(std::index_sequence_for<Keys...>{});
+}
+
+template <typename T, typename... Keys>
+void parallel_radix_sort_by(std::vector<T>& items, thread_pool_t& pool, Keys&&... keys) {
+	parallel_radix_sort_by(std::span<T>(items), pool, std::forward<Keys>(keys)...);
+}
+
+/* Integers, ascending. */
+template <std::integral T>
+void radix_sort(std::vector<T>& values) {
+	radix_sort_by(values, [](T v) { return v; });
+}
+
+/* pair<key, payload> by key; payloads with equal keys keep their order. */
+template <std::integral K, typename V>
+void radix_sort_by_first(std::vector<std::pair<K, V>>& pairs) {
+	radix_sort_by(pairs, [](const std::pair<K, V>& p) { return p.first; });
+}
+
+/* Points in the same order as point_t::operator<; x, y, z, w, or with
+ * z_order (feature_z_sort) z, y, x. Works for point_t and point<N, T>. */
+template <typename P>
+void radix_sort_points(std::vector<P>& points, bool z_order = false) {
+	auto x = [](const P& p) { return p.x; };
+	auto y = [](const P& p) { return p.y; };
+
+	if constexpr (requires(const P& p) { p.w; }) {
+		auto z = [](const P& p) { return p.z; };
+		auto w = [](const P& p) { return p.w; };
+		if (z_order) {
+			radix_sort_by(points, z, y, x);
+		} else {
+			radix_sort_by(points, x, y, z, w);
+		}
+	} else if constexpr (requires(const P& p) { p.z; }) {
+		auto z = [](const P& p) { return p.z; };
+		if (z_order) {
+			radix_sort_by(points, z, y, x);
+		} else {
+			radix_sort_by(points, x, y, z);
+		}
+	} else {
+		radix_sort_by(points, x, y);
+	}
+}
+
+/* vector_t in the order of vector_t::operator<; position, then direction. */
+template <typename V>
+void radix_sort_vectors(std::vector<V>& vectors) {
+	radix_sort_by(vectors,
+				  [](const V& v) { return v.p.x; }, [](const V& v) { return v.p.y; },
+				  [](const V& v) { return v.p.z; }, [](const V& v) { return v.p.w; },
+				  [](const V& v) { return v.dir.x; }, [](const V& v) { return v.dir.y; },
+				  [](const V& v) { return v.dir.z; }, [](const V& v) { return v.dir.w; });
+}
+
+#endif
@@ -0,0 +1,300 @@
+#include "raster.h"
+
+#include <algorithm>  // sort, lower_bound, inplace_merge, unique
+#include <cassert>
+#include <iterator>  // prev
+
+__extension__ typedef __int128 raster_wide_t;
+
+namespace {
+
+/* A non-horizontal edge, from low y to high y. */
+struct raster_edge_t {
+	dimension_t y_lo;
+	dimension_t y_hi;
+	dimension_t x_lo;  // x at y_lo
+	dimension_t dx;	   // x_hi - x_lo
+	dimension_t dy;	   // y_hi - y_lo, > 0
+};
+
+/* Where an edge crosses a row, as num / den (den > 0). */
+struct crossing_t {
+	dimension_t num;
+	dimension_t den;
+
+	bool operator<(const crossing_t& rhs) const {
+		return static_cast<raster_wide_t>(num) * rhs.den < static_cast<raster_wide_t>(rhs.num) * den;
+	}
+};
+
+dimension_t floor_div(dimension_t num, dimension_t den) {
+	dimension_t q = num / den;
+	return (num % den != 0 && num < 0) ? q - 1 : q;
+}
+
+dimension_t ceil_div(dimension_t num, dimension_t den) {
+	dimension_t q = num / den;
+	return (num % den != 0 && num > 0) ? q + 1 : q;
+}
+
+/* Join sorted spans that overlap or touch. */
+void join_spans(std::vector<span_t>& spans) {
+	size_t out = 0;
+	for (size_t i = 0; i < spans.size(); i++) {
+		if (out > 0 && spans[i].first <= spans[out - 1].second + 1) {
+			spans[out - 1].second = std::max(spans[out - 1].second, spans[i].second);
+		} else {
+			spans[out++] = spans[i];
+		}
+	}
+	spans.resize(out);
+}
+
+}  // namespace
+
+raster_t raster_t::rasterize(const std::vector<std::pair<dimension_t, dimension_t>>& vertices) {
+	raster_t raster;
+	if (vertices.empty()) {
+		return raster;
+	}
+
+	std::vector<raster_edge_t> edges;
+	std::vector<std::pair<dimension_t, span_t>> flat;  // horizontal edges and lone vertices, by row
+	dimension_t y_min = vertices[0].second;
+	dimension_t y_max = vertices[0].second;
+
+	for (size_t i = 0; i < vertices.size(); i++) {
+		auto [ax, ay] = vertices[i];
+		auto [bx, by] = vertices[(i + 1) % vertices.size()];
+		y_min = std::min(y_min, ay);
+		y_max = std::max(y_max, ay);
+
+		// every vertex is covered; this also catches the top end of each edge
+		flat.push_back({ay, {ax, ax}});
+
+		if (ay == by) {
+			flat.push_back({ay, {std::min(ax, bx), std::max(ax, bx)}});
+		} else if (ay < by) {
+			edges.push_back({ay, by, ax, bx - ax, by - ay});
+		} else {
+			edges.push_back({by, ay, bx, ax - bx, ay - by});
+		}
+	}
+
+	std::sort(edges.begin(), edges.end(), [](const auto& a, const auto& b) { return a.y_lo < b.y_lo; });
+	std::sort(flat.begin(), flat.end());
+
+	raster.y_min = y_min;
+	raster.rows.resize(static_cast<size_t>(y_max - y_min + 1));
+
+	// active edges cover [y_lo, y_hi), half open so a vertex is crossed once.
+	// Edges of a simple polygon never pass each other, so once sorted by x
+	// the active list stays sorted and each row is one walk along it.
+	std::vector<const raster_edge_t*> active;
+	size_t next_edge = 0;
+	size_t next_flat = 0;
+
+	auto crossing = [](const raster_edge_t* e, dimension_t y) {
+		return crossing_t{e->x_lo * e->dy + (y - e->y_lo) * e->dx, e->dy};
+	};
+
+	for (dimension_t y = y_min; y <= y_max; y++) {
+		std::erase_if(active, [y](const raster_edge_t* e) { return e->y_hi <= y; });
+
+		for (; next_edge < edges.size() && edges[next_edge].y_lo == y; next_edge++) {
+			// by x on this row, then by where it heads (two edges leaving one vertex)
+			const raster_edge_t* e = &edges[next_edge];
+			auto at = std::lower_bound(active.begin(), active.end(), e, [&](const raster_edge_t* a, const raster_edge_t* b) {
+				crossing_t ca = crossing(a, y);
+				crossing_t cb = crossing(b, y);
+				if (ca < cb || cb < ca) {
+					return ca < cb;
+				}
+				return static_cast<raster_wide_t>(a->dx) * b->dy < static_cast<raster_wide_t>(b->dx) * a->dy;
+			});
+			active.insert(at, e);
+		}
+
+		std::vector<span_t>& spans = raster.rows[static_cast<size_t>(y - y_min)];
+
+		// inside between alternate crossings; a crossing on a lattice point is a span end
+		for (size_t i = 0; i + 1 < active.size(); i += 2) {
+			const raster_edge_t* left = active[i];
+			const raster_edge_t* right = active[i + 1];
+
+			dimension_t x1 = left->dx == 0 ? left->x_lo : ceil_div(crossing(left, y).num, left->dy);
+			dimension_t x2 = right->dx == 0 ? right->x_lo : floor_div(crossing(right, y).num, right->dy);
+			if (x1 <= x2) {
+				spans.push_back({x1, x2});
+			}
+		}
+
+		// vertices and horizontal edges, sorted by x already
+		const size_t crossed = spans.size();
+		for (; next_flat < flat.size() && flat[next_flat].first == y; next_flat++) {
+			spans.push_back(flat[next_flat].second);
+		}
+
+		if (crossed != spans.size()) {
+			std::inplace_merge(spans.begin(), spans.begin() + static_cast<std::ptrdiff_t>(crossed), spans.end());
+		}
+		join_spans(spans);
+	}
+
+	return raster;
+}
+
+const std::vector<span_t>& raster_t::row(dimension_t y) const {
+	static const std::vector<span_t> empty;
+	if (y < y_min || y > y_max()) {
+		return empty;
+	}
+	return rows[static_cast<size_t>(y - y_min)];
+}
+
+bool raster_t::contains(dimension_t x, dimension_t y) const {
+	const auto& spans = row(y);
+	auto it = std::upper_bound(spans.begin(), spans.end(), x,
+							   [](dimension_t v, const span_t& s) { return v < s.first; });
+	return it != spans.begin() && x <= std::prev(it)->second;
+}
+
+size_t raster_t::count() const {
+	size_t count = 0;
+	for (const auto& spans : rows) {
+		for (const auto& [x1, x2] : spans) {
+			count += static_cast<size_t>(x2 - x1 + 1);
+		}
+	}
+	return count;
+}
+
+compressed_grid_t compressed_grid_t::compress(const std::vector<std::pair<dimension_t, dimension_t>>& vertices) {
+	compressed_grid_t grid;
+	if (vertices.empty()) {
+		return grid;
+	}
+
+	for (const auto& [x, y] : vertices) {
+		grid.xs.push_back(x);
+		grid.ys.push_back(y);
+	}
+	std::sort(grid.xs.begin(), grid.xs.end());
+	grid.xs.erase(std::unique(grid.xs.begin(), grid.xs.end()), grid.xs.end());
+	std::sort(grid.ys.begin(), grid.ys.end());
+	grid.ys.erase(std::unique(grid.ys.begin(), grid.ys.end()), grid.ys.end());
+
+	grid.width = 2 * grid.xs.size() - 1;
+	grid.height = 2 * grid.ys.size() - 1;
+
+	// the same polygon in cell coordinates; order is kept so it stays simple and rectilinear
+	std::vector<std::pair<dimension_t, dimension_t>> cells;
+	cells.reserve(vertices.size());
+	for (const auto& [x, y] : vertices) {
+		auto cx = std::lower_bound(grid.xs.begin(), grid.xs.end(), x) - grid.xs.begin();
+		auto cy = std::lower_bound(grid.ys.begin(), grid.ys.end(), y) - grid.ys.begin();
+		cells.emplace_back(2 * cx, 2 * cy);
+	}
+
+	for (size_t i = 0; i < cells.size(); i++) {
+		[[maybe_unused]] const auto& a = cells[i];
+		[[maybe_unused]] const auto& b = cells[(i + 1) % cells.size()];
+		assert(a.first == b.first || a.second == b.second);
+	}
+
+	raster_t raster = raster_t::rasterize(cells);
+	assert(raster.y_min == 0 && raster.rows.size() == grid.height);
+
+	grid.inside.assign(grid.width * grid.height, 0);
+	for (size_t cy = 0; cy < grid.height; cy++) {
+		for (const auto& [x1, x2] : raster.rows[cy]) {
+			for (dimension_t cx = x1; cx <= x2; cx++) {
+				grid.inside[cy * grid.width + static_cast<size_t>(cx)] = 1;
+			}
+		}
+	}
+
+	// prefix sums of outside cells that hold lattice points, (width + 1) x (height + 1)
+	const size_t stride = grid.width + 1;
+	grid._outside.assign(stride * (grid.height + 1), 0);
+	for (size_t cy = 0; cy < grid.height; cy++) {
+		for (size_t cx = 0; cx < grid.width; cx++) {
+			uint32_t outside = (!grid.inside[cy * grid.width + cx] &&
+								grid.cell_width(cx) > 0 && grid.cell_height(cy) > 0) ? 1 : 0;
+			grid._outside[(cy + 1) * stride + cx + 1] = outside
+				+ grid._outside[cy * stride + cx + 1]
+				+ grid._outside[(cy + 1) * stride + cx]
+				- grid._outside[cy * stride + cx];
+		}
+	}
+
+	return grid;
+}
+
+dimension_t compressed_grid_t::cell_width(size_t cx) const {
+	return (cx % 2 == 0) ? 1 : xs[cx / 2 + 1] - xs[cx / 2] - 1;
+}
+
+dimension_t compressed_grid_t::cell_height(size_t cy) const {
+	return (cy % 2 == 0) ? 1 : ys[cy / 2 + 1] - ys[cy / 2] - 1;
+}
+
+std::ptrdiff_t compressed_grid_t::cell_of(const std::vector<dimension_t>& coordinates, dimension_t v) {
+	if (coordinates.empty() || v < coordinates.front() || v > coordinates.back()) {
+		return -1;
+	}
+
+	// branch free lower_bound; the compares are unpredictable, a cmov is not
+	const dimension_t* base = coordinates.data();
+	size_t n = coordinates.size();
+	while (n > 1) {
+		size_t half = n / 2;
+		base = (base[half - 1] < v) ? base + half : base;
+		n -= half;
+	}
+	base += (*base < v) ? 1 : 0;
+
+	auto i = base - coordinates.data();
+	return (*base == v) ? 2 * i : 2 * i - 1;
+}
+
+bool compressed_grid_t::contains(dimension_t x, dimension_t y) const {
+	auto cx = cell_of(xs, x);
+	auto cy = cell_of(ys, y);
+	if (cx < 0 || cy < 0) {
+		return false;
+	}
+	return inside[static_cast<size_t>(cy) * width + static_cast<size_t>(cx)] != 0;
+}
+
+bool compressed_grid_t::contains_box(dimension_t x1, dimension_t y1, dimension_t x2, dimension_t y2) const {
+	auto cx1 = cell_of(xs, std::min(x1, x2));
+	auto cx2 = cell_of(xs, std::max(x1, x2));
+	auto cy1 = cell_of(ys, std::min(y1, y2));
+	auto cy2 = cell_of(ys, std::max(y1, y2));
+	if (cx1 < 0 || cx2 < 0 || cy1 < 0 || cy2 < 0) {
+		return false;
+	}
+
+	const size_t stride = width + 1;
+	const auto left = static_cast<size_t>(cx1);
+	const auto right = static_cast<size_t>(cx2) + 1;
+	const auto top = static_cast<size_t>(cy1);
+	const auto bottom = static_cast<size_t>(cy2) + 1;
+
+	uint32_t outside = _outside[bottom * stride + right] - _outside[top * stride + right]
+					 - _outside[bottom * stride + left] + _outside[top * stride + left];
+	return outside == 0;
+}
+
+size_t compressed_grid_t::count() const {
+	size_t count = 0;
+	for (size_t cy = 0; cy < height; cy++) {
+		for (size_t cx = 0; cx < width; cx++) {
+			if (inside[cy * width + cx]) {
+				count += static_cast<size_t>(cell_width(cx) * cell_height(cy));
+			}
+		}
+	}
+	return count;
+}
@@ -0,0 +1,152 @@
+#if !defined(RASTER_H)
+#define RASTER_H
+
+#include <cstddef>
+#include <cstdint>
+#include <cstdlib>	// labs
+#include <numeric>	// gcd
+#include <utility>	// std::pair
+#include <vector>
+
+#include "point.h"
+
+/* Lattice points (tiles) covered by a polygon given as its vertices, without
+ * allocating a charmap_t over the whole bounding box.
+ *
+ *	shoelace_area2()		twice the signed area (positive counter-clockwise)
+ *	boundary_points()		lattice points on the edges
+ *	interior_points()		lattice points strictly inside, by Pick's theorem
+ *	covered_points()		both; what a flood fill of the loop would count
+ *	raster_t				closed spans of covered x for every row, any polygon
+ *	compressed_grid_t		inside/outside per compressed cell, rectilinear polygons
+ *
+ * Vertices are in order, either winding, anything with .x and .y. The
+ * polygon must be simple (no self intersections). Coordinates within +/-2^30.
+ */
+using span_t = std::pair<dimension_t, dimension_t>;	 // [first, second], inclusive
+
+template <typename C>
+dimension_t shoelace_area2(const C& polygon) {
+	dimension_t area2 = 0;
+	for (size_t i = 0; i < polygon.size(); i++) {
+		const auto& a = polygon[i];
+		const auto& b = polygon[(i + 1) % polygon.size()];
+		area2 += static_cast<dimension_t>(a.x) * static_cast<dimension_t>(b.y) -
+				 static_cast<dimension_t>(b.x) * static_cast<dimension_t>(a.y);
+	}
+	return area2;
+}
+
+template <typename C>
+dimension_t boundary_points(const C& polygon) {
+	dimension_t count = 0;
+	for (size_t i = 0; i < polygon.size(); i++) {
+		const auto& a = polygon[i];
+		const auto& b = polygon[(i + 1) % polygon.size()];
+		count += std::gcd(std::labs(static_cast<dimension_t>(b.x) - static_cast<dimension_t>(a.x)),
+						  std::labs(static_cast<dimension_t>(b.y) - static_cast<dimension_t>(a.y)));
+	}
+	return count;
+}
+
+// Pick's theorem: A = I + B/2 - 1
+template <typename C>
+dimension_t interior_points(const C& polygon) {
+	return (std::labs(shoelace_area2(polygon)) - boundary_points(polygon) + 2) / 2;
+}
+
+template <typename C>
+dimension_t covered_points(const C& polygon) {
+	return interior_points(polygon) + boundary_points(polygon);
+}
+
+/* The polygon as sorted, disjoint spans of covered x on every row from
+ * y_min to y_max; built with a scanline over an active edge table, so the
+ * cost is the number of rows times the edges crossing them, not the area.
+ *
+ *	raster_t r = raster_t::from_polygon(tiles);
+ *	for (auto [x1, x2] : r.row(y)) { ... }
+ */
+struct raster_t {
+	dimension_t y_min = 0;
+	std::vector<std::vector<span_t>> rows = {};	 // rows[y - y_min]
+
+	raster_t() {}
+
+	template <typename C>
+	static raster_t from_polygon(const C& polygon) {
+		std::vector<std::pair<dimension_t, dimension_t>> vertices;
+		vertices.reserve(polygon.size());
+		for (const auto& p : polygon) {
+			vertices.emplace_back(static_cast<dimension_t>(p.x), static_cast<dimension_t>(p.y));
+		}
+		return rasterize(vertices);
+	}
+
+	static raster_t rasterize(const std::vector<std::pair<dimension_t, dimension_t>>& vertices);
+
+	dimension_t y_max() const { return y_min + static_cast<dimension_t>(rows.size()) - 1; }
+
+	// spans for row y, empty outside the polygon
+	const std::vector<span_t>& row(dimension_t y) const;
+
+	bool contains(dimension_t x, dimension_t y) const;
+
+	// lattice points covered, should equal covered_points()
+	size_t count() const;
+};
+
+/* Rectilinear polygon on a grid compressed to its vertex coordinates: cell
+ * 2i is the line x = xs[i] and cell 2i + 1 the gap (xs[i], xs[i + 1]), the
+ * same for y. Each cell is entirely inside or outside, so a polygon spanning
+ * millions of tiles needs (2 * vertices)^2 cells at most. Prefix sums over the
+ * outside cells answer "is this box all inside" in O(log n).
+ */
+struct compressed_grid_t {
+	std::vector<dimension_t> xs = {};  // distinct vertex x, sorted
+	std::vector<dimension_t> ys = {};
+	size_t width = 0;				   // 2 * xs.size() - 1 cells
+	size_t height = 0;
+	std::vector<uint8_t> inside = {};  // [cy * width + cx]
+
+	compressed_grid_t() {}
+
+	template <typename C>
+	static compressed_grid_t from_polygon(const C& polygon) {
+		std::vector<std::pair<dimension_t, dimension_t>> vertices;
+		vertices.reserve(polygon.size());
+		for (const auto& p : polygon) {
+			vertices.emplace_back(static_cast<dimension_t>(p.x), static_cast<dimension_t>(p.y));
+		}
+		return compress(vertices);
+	}
+
+	static compressed_grid_t compress(const std::vector<std::pair<dimension_t, dimension_t>>& vertices);
+
+	// lattice columns / rows in a cell
+	dimension_t cell_width(size_t cx) const;
+	dimension_t cell_height(size_t cy) const;
+
+	bool contains(dimension_t x, dimension_t y) const;
+
+	// every lattice point of [x1, x2] x [y1, y2] is covered
+	bool contains_box(dimension_t x1, dimension_t y1, dimension_t x2, dimension_t y2) const;
+
+	template <typename P>
+	bool contains_box(const P& a, const P& b) const {
+		return contains_box(static_cast<dimension_t>(a.x), static_cast<dimension_t>(a.y),
+							static_cast<dimension_t>(b.x), static_cast<dimension_t>(b.y));
+	}
+
+	// lattice points covered, should equal covered_points()
+	size_t count() const;
+
+   private:
+	// outside cells (that hold any lattice points) in [0, cx) x [0, cy)
+	std::vector<uint32_t> _outside = {};
+
+	// cell holding coordinate v, or -1 if v is outside the coordinates
+	static std::ptrdiff_t cell_of(const std::vector<dimension_t>& coordinates, dimension_t v);
+};
+
+#endif
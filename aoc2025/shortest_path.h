@@ -0,0 +1,240 @@
+#if !defined(SHORTEST_PATH_H)
+#define SHORTEST_PATH_H
+
+#include <algorithm>  // fill, max
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <functional>  // std::hash
+#include <utility>	   // std::forward
+#include <vector>
+
+#include "flat_hash.h"
+#include "priority_queue.h"
+
+/* What a search did; time per node is the number to compare.
+ *
+ * Built with -DSEARCH_COUNTERS the searches also count where the work went
+ * (see the fields below); without it the count_...() calls compile to
+ * nothing and the searches run as fast as ever.
+ */
+struct search_stats_t {
+	size_t expanded = 0;  // states popped and settled
+	size_t pushed = 0;
+	double elapsed_ms = 0;
+
+#if defined(SEARCH_COUNTERS)
+	static constexpr bool counting = true;
+
+	size_t pops = 0;
+	size_t stale = 0;		// popped with an outdated cost and skipped
+	size_t relaxed = 0;		// edges looked at
+	size_t max_queue = 0;	// most entries queued at once
+	size_t peak_bytes = 0;	// queue and search arrays as the search ends; none
+							// of them shrink during one, so also the most held
+#else
+	static constexpr bool counting = false;
+#endif
+
+	double ns_per_node() const {
+		return expanded ? elapsed_ms * 1'000'000.0 / static_cast<double>(expanded) : 0;
+	}
+
+#if defined(SEARCH_COUNTERS)
+	void count_pop(size_t queued) {
+		pops++;
+		max_queue = std::max(max_queue, queued + 1);
+	}
+	void count_stale() { stale++; }
+	void count_relaxed() { relaxed++; }
+	void count_bytes(size_t bytes) { peak_bytes = std::max(peak_bytes, bytes); }
+	// a whole frontier taken at once (delta_stepping)
+	void count_frontier(size_t nodes) {
+		pops += nodes;
+		max_queue = std::max(max_queue, nodes);
+	}
+#else
+	void count_pop(size_t) {}
+	void count_stale() {}
+	void count_relaxed() {}
+	void count_bytes(size_t) {}
+	void count_frontier(size_t) {}
+#endif
+
+	/* Add in another's counts; one thread's share of the same search. */
+	void merge(const search_stats_t& other) {
+		expanded += other.expanded;
+		pushed += other.pushed;
+#if defined(SEARCH_COUNTERS)
+		pops += other.pops;
+		stale += other.stale;
+		relaxed += other.relaxed;
+		max_queue = std::max(max_queue, other.max_queue);
+		peak_bytes = std::max(peak_bytes, other.peak_bytes);
+#endif
+	}
+};
+
+constexpr size_t unreached_cost = SIZE_MAX;
+
+/* Best cost so far for states kept in a flat_hash_map. */
+template <typename State, typename Hash = std::hash<State>>
+class hash_store_t {
+   public:
+	size_t get(const State& state) const {
+		auto it = _cost.find(state);
+		return it == _cost.end() ? unreached_cost : it->second.cost;
+	}
+
+	// lower state's cost to cost; false if it was already as low
+	bool improve(const State& state, size_t cost) {
+		size_t& current = _cost[state].cost;
+		if (cost < current) {
+			current = cost;
+			return true;
+		}
+		return false;
+	}
+
+	void clear() { _cost.clear(); }
+	size_t size() const { return _cost.size(); }
+	size_t bytes() const { return _cost.capacity() * (sizeof(State) + sizeof(slot_t) + 1); }
+
+   private:
+	struct slot_t {
+		size_t cost = unreached_cost;
+	};
+
+	flat_hash_map<State, slot_t, Hash> _cost = {};
+};
+
+/* Best cost so far for states numbered by index(state) < size. */
+template <typename State, typename Index>
+class dense_store_t {
+   public:
+	dense_store_t(size_t size, Index index) : _index(index), _cost(size, unreached_cost) {
+	}
+
+	size_t get(const State& state) const { return _cost[_index(state)]; }
+
+	bool improve(const State& state, size_t cost) {
+		size_t& current = _cost[_index(state)];
+		if (cost < current) {
+			current = cost;
+			return true;
+		}
+		return false;
+	}
+
+	void clear() { std::fill(_cost.begin(), _cost.end(), unreached_cost); }
+	size_t size() const { return _cost.size(); }
+	size_t bytes() const { return _cost.capacity() * sizeof(size_t); }
+
+   private:
+	Index _index;
+	std::vector<size_t> _cost;
+};
+
+template <typename State, typename Index>
+dense_store_t<State, Index> make_dense_store(size_t size, Index index) {
+	return {size, index};
+}
+
+/* Dijkstra over any state space, everything known at compile time so the
+ * callbacks inline and can carry state of their own.
+ *
+ *	State		any copyable value; position plus heading, keys held, run length...
+ *	Neighbors	neighbors(state, emit) calls emit(next) for each move
+ *	Cost		cost(from, to) is what the move costs, >= 0
+ *	Store		best cost per state; hash_store_t (any hashable state) or
+ *				dense_store_t (states numbered 0..n-1 by an index function)
+ *	Queue		radix_heap_t by default, or dial_queue_t / binary_queue_t
+ *
+ *	struct crucible_t { point_t p; point_t dir; int run; ... };
+ *	auto search = make_shortest_path<crucible_t>(
+ *		[&](const crucible_t& s, auto&& emit) { ... emit(next); ... },
+ *		[&](const crucible_t&, const crucible_t& to) { return heat(to.p); });
+ *	size_t cost = search.run(start, [&](const crucible_t& s) { return s.p == end; });
+ */
+template <typename State, typename Neighbors, typename Cost,
+		  typename Store = hash_store_t<State>, typename Queue = radix_heap_t<State>>
+class shortest_path_t {
+   public:
+	search_stats_t stats = {};
+
+	shortest_path_t(Neighbors neighbors, Cost cost, Store store = Store(), Queue queue = Queue())
+		: _neighbors(neighbors), _cost(cost), _store(std::move(store)), _empty_queue(std::move(queue)) {
+	}
+
+	/* Cost of the cheapest path from start to a state where is_goal(state),
+	 * unreached_cost if there is none. The store keeps the costs found. */
+	template <typename IsGoal>
+	size_t run(const State& start, IsGoal&& is_goal) {
+		return run(&start, &start + 1, std::forward<IsGoal>(is_goal));
+	}
+
+	// from whichever of [first, last) is cheapest to start from; all cost 0
+	template <typename It, typename IsGoal>
+	size_t run(It first, It last, IsGoal&& is_goal) {
+		auto started = std::chrono::steady_clock::now();
+		_store.clear();
+		stats = {};
+
+		Queue Q = _empty_queue;
+		for (It it = first; it != last; ++it) {
+			if (_store.improve(*it, 0)) {
+				Q.push(0, *it);
+				stats.pushed++;
+			}
+		}
+
+		size_t result = unreached_cost;
+		while (!Q.empty()) {
+			auto [cost, state] = Q.pop();
+			stats.count_pop(Q.size());
+			if (cost > _store.get(state)) {
+				stats.count_stale();
+				continue;  // already settled cheaper
+			}
+			stats.expanded++;
+
+			if (is_goal(state)) {
+				result = cost;
+				break;
+			}
+
+			_neighbors(state, [&](const State& next) {
+				stats.count_relaxed();
+				size_t next_cost = cost + _cost(state, next);
+				if (_store.improve(next, next_cost)) {
+					Q.push(next_cost, next);
+					stats.pushed++;
+				}
+			});
+		}
+
+		stats.count_bytes(Q.bytes() + _store.bytes());
+		stats.elapsed_ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - started).count();
+		return result;
+	}
+
+	// cheapest cost found to state, unreached_cost if it was not reached
+	size_t distance(const State& state) const { return _store.get(state); }
+
+	const Store& store() const { return _store; }
+
+   private:
+	Neighbors _neighbors;
+	Cost _cost;
+	Store _store;
+	Queue _empty_queue;	 // dial_queue_t needs its max weight; copied for each run
+};
+
+template <typename State, typename Store = hash_store_t<State>, typename Queue = radix_heap_t<State>,
+		  typename Neighbors, typename Cost>
+shortest_path_t<State, Neighbors, Cost, Store, Queue> make_shortest_path(Neighbors neighbors, Cost cost,
+																		 Store store = Store(), Queue queue = Queue()) {
+	return {neighbors, cost, std::move(store), std::move(queue)};
+}
+
+#endif
@@ -1,6 +1,8 @@
 
 #include "sutherland-hodgeman.h"
 
+#include <cassert>
+
 // Sutherland-Hodgman clipping
 std::vector<point_t> sutherland_hodgman(
     std::span<point_t const> subject_polygon, std::span<point_t const> clip_polygon) {
@@ -15,8 +17,10 @@ std::vector<point_t> sutherland_hodgman(
     std::vector<point_t> input;
 
     for (point_t p2 : clip_polygon) {
-        input.clear();
-        input.insert(input.end(), ring.begin(), ring.end());
+        input.swap(ring);
+        if (input.empty()) {
+            break;
+        }
         point_t s = input[input.size() - 1];
 
         ring.clear();
@@ -40,3 +44,116 @@ std::vector<point_t> sutherland_hodgman(
 
     return ring;
 }
+
+// num / den rounded to nearest, halves away from zero; den > 0
+static dimension_t divide_rounded(clip_wide_t num, clip_wide_t den) {
+    clip_wide_t q = num / den;
+    clip_wide_t r = num % den;
+    if (2 * (r < 0 ? -r : r) >= den) {
+        q += (num < 0) ? -1 : 1;
+    }
+    return static_cast<dimension_t>(q);
+}
+
+static clip_wide_t gcd_wide(clip_wide_t a, clip_wide_t b) {
+    a = a < 0 ? -a : a;
+    b = b < 0 ? -b : b;
+    while (b != 0) {
+        clip_wide_t t = a % b;
+        a = b;
+        b = t;
+    }
+    return a;
+}
+
+rational_point_t intersection_exact(const point_t& a, const point_t& b, const point_t& s, const point_t& e) {
+    // signed distances (times |b - a|) of s and e from the line; they differ in sign
+    clip_wide_t fs = static_cast<clip_wide_t>(b.x - a.x) * (s.y - a.y) -
+                     static_cast<clip_wide_t>(b.y - a.y) * (s.x - a.x);
+    clip_wide_t fe = static_cast<clip_wide_t>(b.x - a.x) * (e.y - a.y) -
+                     static_cast<clip_wide_t>(b.y - a.y) * (e.x - a.x);
+
+    // s + (e - s) * fs / (fs - fe); within 2^124 for coordinates within 2^40
+    clip_wide_t den = fs - fe;
+    assert(den != 0);
+    if (den < 0) {
+        fs = -fs;
+        den = -den;
+    }
+
+    clip_wide_t x = static_cast<clip_wide_t>(s.x) * den + static_cast<clip_wide_t>(e.x - s.x) * fs;
+    clip_wide_t y = static_cast<clip_wide_t>(s.y) * den + static_cast<clip_wide_t>(e.y - s.y) * fs;
+    clip_wide_t g = gcd_wide(gcd_wide(x, y), den);
+    return {x / g, y / g, den / g};
+}
+
+point_t intersection_rounded(const point_t& a, const point_t& b, const point_t& s, const point_t& e) {
+    rational_point_t p = intersection_exact(a, b, s, e);
+    return {divide_rounded(p.x, p.den), divide_rounded(p.y, p.den)};
+}
+
+std::span<const point_t> sutherland_hodgman_exact(
+    std::span<const point_t> subject_polygon, std::span<const point_t> clip_polygon, clip_scratch_t& scratch) {
+    std::vector<point_t>& ring = scratch.ring;
+    std::vector<point_t>& input = scratch.input;
+
+    ring.clear();
+    if (clip_polygon.empty() || subject_polygon.empty()) {
+        return ring;
+    }
+
+    ring.assign(subject_polygon.begin(), subject_polygon.end());
+
+    point_t p1 = clip_polygon[clip_polygon.size() - 1];
+
+    for (const point_t& p2 : clip_polygon) {
+        // last pass's output is this pass's input; swap, don't copy
+        input.swap(ring);
+        ring.clear();
+        if (input.empty()) {
+            break;
+        }
+
+        point_t s = input[input.size() - 1];
+        bool s_inside = is_inside_exact(s, p1, p2);
+
+        for (const point_t& e : input) {
+            bool e_inside = is_inside_exact(e, p1, p2);
+            if (e_inside != s_inside) {
+                ring.push_back(intersection_rounded(p1, p2, s, e));
+            }
+
+            if (e_inside) {
+                ring.push_back(e);
+            }
+
+            s = e;
+            s_inside = e_inside;
+        }
+
+        p1 = p2;
+    }
+
+    return ring;
+}
+
+std::vector<point_t> sutherland_hodgman_exact(std::span<const point_t> subject, std::span<const point_t> clip) {
+    clip_scratch_t scratch;
+    auto ring = sutherland_hodgman_exact(subject, clip, scratch);
+    return {ring.begin(), ring.end()};
+}
+
+std::vector<std::vector<point_t>> sutherland_hodgman_batch(
+    std::span<const std::vector<point_t>> subjects, std::span<const point_t> clip, thread_pool_t& pool) {
+    std::vector<std::vector<point_t>> result(subjects.size());
+
+    pool.parallel_for(subjects.size(), [&](size_t begin, size_t end) {
+        clip_scratch_t scratch;
+        for (size_t i = begin; i < end; i++) {
+            auto ring = sutherland_hodgman_exact(subjects[i], clip, scratch);
+            result[i].assign(ring.begin(), ring.end());
+        }
+    });
+
+    return result;
+}
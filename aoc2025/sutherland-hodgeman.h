@@ -1,31 +1,97 @@
+#if !defined(SUTHERLAND_HODGEMAN_H)
+#define SUTHERLAND_HODGEMAN_H
+
+#include <cstdint>
 #include <span>
 #include <vector>
 #include <print>
 
+#include "parallel.h"
 #include "point.h"
 
-constexpr point_t operator*(const point_t& a, float b) {
+inline point_t operator*(const point_t& a, float b) {
 	return {(float)a.x * b, (float)a.y * b};
 }
 
-constexpr float dot(const point_t& a, const point_t& b) {
+inline float dot(const point_t& a, const point_t& b) {
 	return (float)a.x * (float)b.x + (float)a.y * (float)b.y;
 }
 
-constexpr float cross(const point_t& a, const point_t& b) {
+inline float cross(const point_t& a, const point_t& b) {
 	return (float)a.x * (float)b.y - (float)b.x * (float)a.y;
 }
 
 // check if a point is on the LEFT side of an edge
-constexpr bool is_inside(const point_t& point, const point_t& a, const point_t& b) {
+inline bool is_inside(const point_t& point, const point_t& a, const point_t& b) {
     return (cross(a - b, point) + cross(b, a)) < 0.0f;
 }
 
 // calculate intersection point
-constexpr point_t intersection(const point_t& a1, const point_t& a2, const point_t& b1, const point_t& b2) {
+inline point_t intersection(const point_t& a1, const point_t& a2, const point_t& b1, const point_t& b2) {
     return ((b1 - b2) * cross(a1, a2) - (a1 - a2) * cross(b1, b2)) *
            (1.0f / cross(a1 - a2, b1 - b2));
 }
 
 // Sutherland-Hodgman clipping
-std::vector<point_t> sutherland_hodgman(std::span<point_t const> subject, std::span<point_t const> clip);
\ No newline at end of file
+std::vector<point_t> sutherland_hodgman(std::span<point_t const> subject, std::span<point_t const> clip);
+
+/* Integer versions of the above.
+ *
+ * The float helpers lose precision past 2^24 and truncate intersections.
+ * These make the orientation tests exactly in 128 bit integers, and
+ * intersection_exact() gives the true crossing as a fraction. Clipping has
+ * to hand back point_t, so the clipper rounds each new vertex to the nearest
+ * lattice point (intersection_rounded()); its output is exact whenever the
+ * crossings are lattice points, as when subject and clip edges are all
+ * axis-aligned. Coordinates must be within +/-2^40.
+ */
+__extension__ typedef __int128 clip_wide_t;
+
+// > 0 if p is left of a->b, < 0 if right, 0 if on the line
+inline int orientation(const point_t& a, const point_t& b, const point_t& p) {
+    clip_wide_t c = static_cast<clip_wide_t>(b.x - a.x) * (p.y - a.y) -
+                    static_cast<clip_wide_t>(b.y - a.y) * (p.x - a.x);
+    return (c > 0) - (c < 0);
+}
+
+// same side convention as is_inside(); strictly left of a->b
+inline bool is_inside_exact(const point_t& p, const point_t& a, const point_t& b) {
+    return orientation(a, b, p) > 0;
+}
+
+// (x / den, y / den) in lowest terms, den > 0
+struct rational_point_t {
+    clip_wide_t x;
+    clip_wide_t y;
+    clip_wide_t den;
+
+    bool operator==(const rational_point_t&) const = default;
+};
+
+// where segment s->e crosses the line a->b, exactly; s and e on opposite sides
+rational_point_t intersection_exact(const point_t& a, const point_t& b, const point_t& s, const point_t& e);
+
+// the same, rounded to the nearest lattice point (halves away from zero)
+point_t intersection_rounded(const point_t& a, const point_t& b, const point_t& s, const point_t& e);
+
+/* Reusable buffers for sutherland_hodgman_exact(); keep one per thread and
+ * pass it to every call so clipping stops allocating once they have grown. */
+struct clip_scratch_t {
+    std::vector<point_t> ring = {};
+    std::vector<point_t> input = {};
+};
+
+/* Clip subject against clip (convex, vertices counter-clockwise). The result
+ * lives in scratch and is valid until its next use. */
+std::span<const point_t> sutherland_hodgman_exact(
+    std::span<const point_t> subject, std::span<const point_t> clip, clip_scratch_t& scratch);
+
+std::vector<point_t> sutherland_hodgman_exact(std::span<const point_t> subject, std::span<const point_t> clip);
+
+/* Clip every subject against the same clip polygon, spread across the pool.
+ * result[i] is subjects[i] clipped. */
+std::vector<std::vector<point_t>> sutherland_hodgman_batch(
+    std::span<const std::vector<point_t>> subjects, std::span<const point_t> clip,
+    thread_pool_t& pool = thread_pool_t::shared());
+
+#endif
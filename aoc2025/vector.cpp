@@ -10,3 +10,8 @@ std::ostream& operator<<(std::ostream& os, const vector_t& p) {
 	os << p.p << "," << p.dir;
 	return os;
 }
+
+std::ostream& operator<<(std::ostream& os, const packed_vector_t& s) {
+	os << s.x() << "," << s.y() << " " << (s.has_heading() ? compass_names[s.heading()] : "none");
+	return os;
+}
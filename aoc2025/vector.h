@@ -1,6 +1,8 @@
 #if !defined(VECTOR_T_H)
 #define VECTOR_T_H
 
+#include <array>
+#include <cstdint>
 #include <cstring>	 // strtok, strdup
 #include <iomanip>	 // setw and setprecision on output
 #include <iostream>	 // cout
@@ -9,8 +11,13 @@
 #include <vector>
 #include <cassert>
 
+#include "neighborhood.h"
 #include "point.h"
 
+/* Names of the compass_t directions, by index */
+constexpr const char* compass_names[] = {
+	"east", "northeast", "north", "northwest", "west", "southwest", "south", "southeast"};
+
 struct vector_t {
 	point_t p = {0, 0};
 	point_t dir = {0, 0};
@@ -44,24 +51,16 @@ struct vector_t {
 		return this->p == other.p && this->dir == other.dir;
 	}
 
-	std::string direction_name() {
+	std::string direction_name() const {
 		// Can only work with unit vectors
 		assert(this->dir.x == 0 || this->dir.x == 1 || this->dir.x == -1);
 		assert(this->dir.y == 0 || this->dir.y == 1 || this->dir.y == -1);
 
-		// change in direction when rotating left in 45 degree steps
-		// East (1,0) -> North East (1,-1) -> North (0,1), etc...
-		std::vector<point_t> directions = {
-			{1, 0}, {1, 1}, {0, 1}, {-1, 1}, {-1, 0}, {-1, -1}, {0, -1}, {1, -1}};
-
-		std::vector<std::string> names = {
-			"east", "northeast", "north", "northwest", "west", "southwest", "south", "southeast"};
-
 		// find offset of vector's direction in direction table
-		size_t dir_n = 0;
-		for (; dir_n < directions.size(); dir_n++) {
-			if (this->dir == directions[dir_n]) {
-				return names[dir_n];
+		if (this->dir.z == 0 && this->dir.w == 0) {
+			size_t dir_n = compass_t::index_of(this->dir);
+			if (dir_n < compass_t::size) {
+				return compass_names[dir_n];
 			}
 		}
 
@@ -73,15 +72,18 @@ struct vector_t {
 		// only works with 90 degree increments
 		assert(angle == 90 || angle == 180 || angle == 270);
 
-		point_t next = this->dir;
-		while (angle > 0) {
-			auto temp = next.x;
-			next.x = -next.y;
-			next.y = temp;
-			angle -= 90;
+		const point_t d = this->dir;
+		switch (angle) {
+			case 90:
+				this->dir = {-d.y, d.x};
+				break;
+			case 180:
+				this->dir = {-d.x, -d.y};
+				break;
+			default:
+				this->dir = {d.y, -d.x};
+				break;
 		}
-
-		this->dir = next;
 	}
 
 	// changes direction vector to the right in increments of 90-degrees
@@ -92,11 +94,188 @@ struct vector_t {
 
 std::ostream& operator<<(std::ostream& os, const vector_t& p);
 
+/* A 2D position and compass heading packed into one uint64_t, for keying
+ * search state (dist/pred tables, dense arrays, flat hash maps) without the
+ * 80 bytes and cascaded compares of a vector_t.
+ *
+ *	bits  0..3	heading, compass_t index 0..7 or no_direction (8)
+ *	bits  4..31	x + 2^27
+ *	bits 32..59	y + 2^27
+ *
+ * x and y must be within [-2^27, 2^27). With the offset the keys order
+ * like (y, x, heading), so sorting keys gives row-major order.
+ *
+ *	packed_vector_t s(vector_t(p, {1, 0}));
+ *	s = s.turned_left(90).stepped();
+ *	vector_t v = s;
+ */
+struct packed_vector_t {
+	using key_t = uint64_t;
+
+	static constexpr unsigned coordinate_bits = 28;
+	static constexpr dimension_t coordinate_min = -(dimension_t{1} << (coordinate_bits - 1));
+	static constexpr dimension_t coordinate_max = (dimension_t{1} << (coordinate_bits - 1)) - 1;
+
+	static constexpr unsigned directions = compass_t::size;
+	static constexpr unsigned no_direction = directions;
+
+	key_t key = 0;
+
+	constexpr packed_vector_t() = default;
+
+	constexpr packed_vector_t(dimension_t x, dimension_t y, unsigned heading = no_direction)
+		: key(pack(x, y, heading)) {
+	}
+
+	packed_vector_t(const point_t& p, unsigned heading = no_direction)
+		: packed_vector_t(p.x, p.y, heading) {
+	}
+
+	// direction must be one of the compass_t unit steps or (0, 0)
+	explicit packed_vector_t(const vector_t& v)
+		: packed_vector_t(v.p.x, v.p.y, heading_of(v.dir)) {
+		assert(v.p.z == 0 && v.p.w == 0);
+		assert(v.dir == point_t(0, 0) || heading() != no_direction);
+	}
+
+	static constexpr packed_vector_t from_key(key_t key) {
+		packed_vector_t s;
+		s.key = key;
+		return s;
+	}
+
+	// compass_t index of a direction, no_direction for (0, 0) or anything else
+	static unsigned heading_of(const point_t& dir) {
+		if (dir.z != 0 || dir.w != 0) {
+			return no_direction;
+		}
+		return static_cast<unsigned>(compass_t::index_of(dir));
+	}
+
+	constexpr dimension_t x() const {
+		return static_cast<dimension_t>((key >> 4) & coordinate_mask) + coordinate_min;
+	}
+
+	constexpr dimension_t y() const {
+		return static_cast<dimension_t>((key >> 32) & coordinate_mask) + coordinate_min;
+	}
+
+	constexpr unsigned heading() const {
+		return static_cast<unsigned>(key & 0xf);
+	}
+
+	constexpr bool has_heading() const {
+		return heading() != no_direction;
+	}
+
+	point_t position() const {
+		return {x(), y()};
+	}
+
+	// unit step for the heading, (0, 0) when there is none
+	point_t direction() const {
+		if (!has_heading()) {
+			return {0, 0};
+		}
+		const offset_t& step = compass_t::steps[heading()];
+		return {step.dx, step.dy};
+	}
+
+	// same position, no heading; e.g. to key "visited this tile" regardless of facing
+	constexpr packed_vector_t position_only() const {
+		return with_heading(no_direction);
+	}
+
+	constexpr packed_vector_t with_heading(unsigned heading) const {
+		return from_key((key & ~key_t{0xf}) | heading);
+	}
+
+	// rotate left (counter-clockwise) in multiples of 45 degrees, any sign
+	constexpr packed_vector_t turned_left(dimension_t angle) const {
+		assert(angle % 45 == 0);
+		if (!has_heading()) {
+			return *this;
+		}
+		return with_heading(rotate_left[heading()][static_cast<size_t>(((angle / 45) % 8 + 8) % 8)]);
+	}
+
+	constexpr packed_vector_t turned_right(dimension_t angle) const {
+		return turned_left(-angle);
+	}
+
+	constexpr packed_vector_t reversed() const {
+		return turned_left(180);
+	}
+
+	// move distance steps along the heading
+	constexpr packed_vector_t stepped(dimension_t distance = 1) const {
+		if (!has_heading()) {
+			return *this;
+		}
+		const offset_t& step = compass_t::steps[heading()];
+		return {x() + step.dx * distance, y() + step.dy * distance, heading()};
+	}
+
+	// move by (dx, dy) and face that way (no_direction if it is not a compass step)
+	constexpr packed_vector_t moved(dimension_t dx, dimension_t dy) const {
+		return {x() + dx, y() + dy, static_cast<unsigned>(compass_t::index_of(dx, dy))};
+	}
+
+	vector_t to_vector() const {
+		return vector_t(position(), direction());
+	}
+
+	explicit operator vector_t() const {
+		return to_vector();
+	}
+
+	constexpr auto operator<=>(const packed_vector_t&) const = default;
+
+   private:
+	static constexpr key_t coordinate_mask = (key_t{1} << coordinate_bits) - 1;
+
+	// rotate_left[heading][steps] is heading turned left steps * 45 degrees
+	static constexpr auto rotate_left = [] {
+		std::array<std::array<uint8_t, directions>, directions> table{};
+		for (unsigned h = 0; h < directions; h++) {
+			for (unsigned s = 0; s < directions; s++) {
+				table[h][s] = static_cast<uint8_t>((h + s) % directions);
+			}
+		}
+		return table;
+	}();
+
+	static constexpr key_t pack(dimension_t x, dimension_t y, unsigned heading) {
+		assert(coordinate_min <= x && x <= coordinate_max);
+		assert(coordinate_min <= y && y <= coordinate_max);
+		assert(heading <= no_direction);
+		return (static_cast<key_t>(y - coordinate_min) << 32) |
+			   (static_cast<key_t>(x - coordinate_min) << 4) |
+			   static_cast<key_t>(heading);
+	}
+};
+
+static_assert(sizeof(packed_vector_t) == 8);
+static_assert(packed_vector_t(3, -4, 0).turned_left(90).heading() == 2);
+static_assert(packed_vector_t(3, -4, 2).stepped(2).y() == -2);
+static_assert(packed_vector_t(5, 7, 3).position_only() == packed_vector_t(5, 7, 6).position_only());
+static_assert(!packed_vector_t(5, 7, 3).position_only().has_heading());
+static_assert(packed_vector_t(-5, 7, 6).turned_right(270).y() == 7);
+
+std::ostream& operator<<(std::ostream& os, const packed_vector_t& s);
+
 /* Hash function for a vector, so that it can be in unordered set and map */
 template <>
 struct std::hash<vector_t> {
 	size_t operator()(const vector_t& v) const {
-		return std::hash<size_t>()((((size_t)v.p.x & 0xFFFF) << 32) | (((size_t)v.p.y & 0xFFFF) << 24) | (((size_t)v.dir.x & 0xFFFF) << 16) | (((size_t)v.dir.y & 0xFFFF)));
+		return hash_values(v.p.x, v.p.y, v.p.z, v.p.w, v.dir.x, v.dir.y, v.dir.z, v.dir.w);
+	}
+};
+
+template <>
+struct std::hash<packed_vector_t> {
+	size_t operator()(const packed_vector_t& s) const {
+		return static_cast<size_t>(hash_mix(s.key));
 	}
 };
 #endif
\ No newline at end of file
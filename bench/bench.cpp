@@ -0,0 +1,73 @@
+/* Benchmarks for the shared aoc2025 code
+ *
+ * ./bench [-v] [-n count] [name ...]
+ */
+#include <getopt.h>	 // getopt
+
+#include <cstdlib>	// strtoul
+#include <cstring>	// strcmp
+#include <print>	// formatted print
+
+#include "bench.h"
+
+struct benchmark_t {
+	const char* name;
+	void (*fn)(size_t n, bool verbose);
+};
+
+static const benchmark_t benchmarks[] = {
+	{"clip", bench_clip},
+	{"crt", bench_crt},
+	{"delta", bench_delta},
+	{"dijkstra", bench_dijkstra},
+	{"graph", bench_graph},
+	{"hash", bench_hash},
+	{"kdtree", bench_kdtree},
+	{"morton", bench_morton},
+	{"mrf", bench_mrf},
+	{"parse", bench_parse},
+	{"polygon", bench_polygon},
+	{"raster", bench_raster},
+	{"sort", bench_sort},
+};
+
+int main(int argc, char* argv[]) {
+	bool verbose = false;
+	size_t n = 1'000'000;
+
+	int c;
+	while ((c = getopt(argc, argv, "vn:")) != -1) {
+		switch (c) {
+			case 'v':
+				verbose = !verbose;
+				break;
+			case 'n':
+				n = std::strtoul(optarg, nullptr, 10);
+				break;
+			default:
+				std::print(stderr, "ERROR: Unknown option \"{}\"\n", c);
+				exit(1);
+		}
+	}
+
+	argc -= optind;
+	argv += optind;
+
+	for (const auto& benchmark : benchmarks) {
+		bool selected = argc == 0;
+		for (int i = 0; i < argc; i++) {
+			selected = selected || std::strcmp(argv[i], benchmark.name) == 0;
+		}
+
+		if (selected) {
+			std::print("{}:\n", benchmark.name);
+			benchmark.fn(n, verbose);
+		}
+	}
+
+	if (failures != 0) {
+		std::print(stderr, "ERROR: {} checks failed\n", failures);
+		return 1;
+	}
+	return 0;
+}
@@ -0,0 +1,51 @@
+#if !defined(BENCH_H)
+#define BENCH_H
+
+#include <chrono>  // high resolution timer
+#include <format>
+#include <print>   // formatted print
+#include <string>
+#include <utility>  // std::forward
+
+/* for pretty printing durations */
+using duration_t = std::chrono::duration<double, std::milli>;
+
+/* Run fn once and return how long it took. */
+template <typename F>
+duration_t time_it(F&& fn) {
+	auto start = std::chrono::high_resolution_clock::now();
+	fn();
+	return std::chrono::high_resolution_clock::now() - start;
+}
+
+/* One line of benchmark output; result is printed so the work cannot be optimized away. */
+inline void report(const std::string& label, duration_t time, size_t result) {
+	std::print("{:>30} ({:>10.4f}ms) {}\n", label, time.count(), result);
+}
+
+/* Checks that fail are counted; ./bench exits non-zero if any did. */
+inline size_t failures = 0;
+
+/* An ERROR line for a check that failed. */
+template <typename... Args>
+void report_error(std::format_string<Args...> format, Args&&... args) {
+	failures++;
+	std::print("ERROR: {}\n", std::format(format, std::forward<Args>(args)...));
+}
+
+/* Each benchmark gets the element count to work with and the verbose flag. */
+void bench_clip(size_t n, bool verbose);
+void bench_crt(size_t n, bool verbose);
+void bench_delta(size_t n, bool verbose);
+void bench_dijkstra(size_t n, bool verbose);
+void bench_graph(size_t n, bool verbose);
+void bench_hash(size_t n, bool verbose);
+void bench_kdtree(size_t n, bool verbose);
+void bench_morton(size_t n, bool verbose);
+void bench_mrf(size_t n, bool verbose);
+void bench_parse(size_t n, bool verbose);
+void bench_polygon(size_t n, bool verbose);
+void bench_raster(size_t n, bool verbose);
+void bench_sort(size_t n, bool verbose);
+
+#endif
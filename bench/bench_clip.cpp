@@ -0,0 +1,109 @@
+/* Convex polygon clipping from sutherland-hodgeman.h
+ *
+ * Random rectangles clipped to one rectangle with the float
+ * sutherland_hodgman, the integer sutherland_hodgman_exact (a new vector
+ * each call, then one scratch kept throughout) and sutherland_hodgman_batch
+ * on the shared pool. Every crossing is a lattice point, so each clipped
+ * area must be exactly the two rectangles' overlap; the number printed is
+ * how many came out otherwise. The float version truncates its crossings
+ * (749.9999 becomes 749), so it misses some even near the origin and most
+ * once moved out past 2^24; the integer versions must get every one.
+ */
+#include <algorithm>  // min, max
+#include <print>
+#include <random>
+#include <span>
+#include <string>
+#include <vector>
+
+#include "bench.h"
+#include "parallel.h"
+#include "point.h"
+#include "sutherland-hodgeman.h"
+
+/* Twice the area, by the shoelace formula */
+static clip_wide_t twice_area(std::span<const point_t> polygon) {
+	clip_wide_t area = 0;
+	for (size_t i = 0; i < polygon.size(); i++) {
+		const point_t& a = polygon[i];
+		const point_t& b = polygon[(i + 1) % polygon.size()];
+		area += static_cast<clip_wide_t>(a.x) * b.y - static_cast<clip_wide_t>(b.x) * a.y;
+	}
+	return area;
+}
+
+/* Counter-clockwise, so the inside is on the left of each edge */
+static std::vector<point_t> rectangle(dimension_t x0, dimension_t y0, dimension_t x1, dimension_t y1) {
+	return {point_t(x0, y0), point_t(x1, y0), point_t(x1, y1), point_t(x0, y1)};
+}
+
+static void bench_clip_at(size_t n, dimension_t base, const std::string& label) {
+	std::mt19937_64 rng(2025);
+	std::uniform_int_distribution<dimension_t> corner(0, 1000);
+	std::uniform_int_distribution<dimension_t> side(1, 300);
+
+	const dimension_t lo = base + 250;
+	const dimension_t hi = base + 750;
+	const std::vector<point_t> clip = rectangle(lo, lo, hi, hi);
+
+	std::vector<std::vector<point_t>> subjects(n);
+	std::vector<clip_wide_t> expected(n);
+	for (size_t i = 0; i < n; i++) {
+		const dimension_t x0 = base + corner(rng);
+		const dimension_t y0 = base + corner(rng);
+		const dimension_t x1 = x0 + side(rng);
+		const dimension_t y1 = y0 + side(rng);
+		subjects[i] = rectangle(x0, y0, x1, y1);
+
+		const dimension_t w = std::max<dimension_t>(0, std::min(x1, hi) - std::max(x0, lo));
+		const dimension_t h = std::max<dimension_t>(0, std::min(y1, hi) - std::max(y0, lo));
+		expected[i] = 2 * static_cast<clip_wide_t>(w) * h;
+	}
+
+	size_t wrong = 0;
+	auto time = time_it([&]() {
+		for (size_t i = 0; i < n; i++) {
+			wrong += twice_area(sutherland_hodgman(subjects[i], clip)) != expected[i];
+		}
+	});
+	report(label + " float", time, wrong);
+
+	wrong = 0;
+	time = time_it([&]() {
+		for (size_t i = 0; i < n; i++) {
+			wrong += twice_area(sutherland_hodgman_exact(subjects[i], clip)) != expected[i];
+		}
+	});
+	report(label + " exact", time, wrong);
+	const bool exact_wrong = wrong != 0;
+
+	wrong = 0;
+	time = time_it([&]() {
+		clip_scratch_t scratch;
+		for (size_t i = 0; i < n; i++) {
+			wrong += twice_area(sutherland_hodgman_exact(subjects[i], clip, scratch)) != expected[i];
+		}
+	});
+	report(label + " exact, scratch", time, wrong);
+
+	std::vector<std::vector<point_t>> clipped;
+	time = time_it([&]() { clipped = sutherland_hodgman_batch(subjects, clip); });
+	wrong = 0;
+	for (size_t i = 0; i < n; i++) {
+		wrong += twice_area(clipped[i]) != expected[i];
+	}
+	report(label + " batch", time, wrong);
+
+	if (exact_wrong || wrong != 0) {
+		report_error("integer clipping area differs from the overlap at {}", label);
+	}
+}
+
+void bench_clip(size_t n, bool verbose) {
+	if (verbose) {
+		std::print("{} rectangles, {} threads for the batch\n", n, thread_pool_t::shared().size());
+	}
+
+	bench_clip_at(n, 0, "near 0");
+	bench_clip_at(n, dimension_t{1} << 30, "at 2^30");
+}
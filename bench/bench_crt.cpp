@@ -0,0 +1,147 @@
+/* Chinese remainders with chinese_remainder.h
+ *
+ * Systems over three primes near a million (product near 2^60): the old
+ * solver, which multiplies in size_t and overflows, against crt_solver_t
+ * built for each system and one built once for solve_all(). Then moduli
+ * sharing factors, the same with one remainder nudged so they contradict,
+ * and moduli whose lcm does not fit. Every answer is checked; the number
+ * printed is how many were wrong.
+ */
+#include <cstdint>
+#include <optional>
+#include <print>
+#include <random>
+#include <vector>
+
+#include "bench.h"
+#include "chinese_remainder.h"
+
+/* chinese_remainder as it was; products of the moduli in size_t */
+static size_t legacy_mod_inverse(size_t p_a, size_t p_m) {
+	long m = static_cast<long>(p_m);
+	long a = static_cast<long>(p_a);
+	long x0 = 0;
+	long x1 = 1;
+	const long m0 = m;
+
+	if (m == 1) {
+		return 0;
+	}
+
+	while (a > 1) {
+		long q = a / m;
+		long t = m;
+		m = a % m, a = t;
+		t = x0;
+		x0 = x1 - q * x0;
+		x1 = t;
+	}
+
+	if (x1 < 0) {
+		x1 += m0;
+	}
+	return static_cast<size_t>(x1);
+}
+
+static size_t legacy_chinese_remainder(const std::vector<size_t>& remainders, const std::vector<size_t>& numbers) {
+	size_t prod = 1;
+	for (size_t n : numbers) {
+		prod *= n;
+	}
+
+	size_t result = 0;
+	for (size_t i = 0; i < numbers.size(); i++) {
+		size_t pp = prod / numbers[i];
+		result += remainders[i] * legacy_mod_inverse(pp, numbers[i]) * pp;
+	}
+	return result % prod;
+}
+
+/* n systems of x % moduli[i] for random x below the lcm; x is the answer */
+static void make_systems(size_t n, const std::vector<size_t>& moduli, std::mt19937_64& rng,
+						 std::vector<std::vector<size_t>>& systems, std::vector<size_t>& answers) {
+	std::uniform_int_distribution<size_t> below(0, lcm(moduli) - 1);
+	systems.assign(n, {});
+	answers.assign(n, 0);
+	for (size_t s = 0; s < n; s++) {
+		answers[s] = below(rng);
+		for (size_t m : moduli) {
+			systems[s].push_back(answers[s] % m);
+		}
+	}
+}
+
+static size_t count_wrong(const std::vector<std::optional<size_t>>& solutions, const std::vector<size_t>& answers) {
+	size_t wrong = 0;
+	for (size_t s = 0; s < answers.size(); s++) {
+		wrong += solutions[s] != answers[s];
+	}
+	return wrong;
+}
+
+void bench_crt(size_t n, bool verbose) {
+	std::mt19937_64 rng(2025);
+	std::vector<std::vector<size_t>> systems;
+	std::vector<size_t> answers;
+
+	const std::vector<size_t> primes = {999'983, 999'979, 999'961};
+	make_systems(n, primes, rng, systems, answers);
+	if (verbose) {
+		std::print("{} systems, lcm {}\n", n, lcm(primes));
+	}
+
+	size_t wrong = 0;
+	auto time = time_it([&]() {
+		for (size_t s = 0; s < n; s++) {
+			wrong += legacy_chinese_remainder(systems[s], primes) != answers[s];
+		}
+	});
+	report("legacy chinese_remainder", time, wrong);
+
+	wrong = 0;
+	time = time_it([&]() {
+		for (size_t s = 0; s < n; s++) {
+			wrong += crt_solver_t(primes).solve(systems[s]) != answers[s];
+		}
+	});
+	report("crt_solver_t each", time, wrong);
+	size_t errors = wrong;
+
+	const crt_solver_t coprime(primes);
+	std::vector<std::optional<size_t>> solutions;
+	time = time_it([&]() { solutions = coprime.solve_all(systems); });
+	wrong = count_wrong(solutions, answers);
+	report("crt_solver_t solve_all", time, wrong);
+	errors += wrong;
+
+	// most pairs share a factor; lcm 360360, far below the product
+	const std::vector<size_t> shared = {840, 198, 910, 1001, 72};
+	make_systems(n, shared, rng, systems, answers);
+	const crt_solver_t non_coprime(shared);
+	time = time_it([&]() { solutions = non_coprime.solve_all(systems); });
+	wrong = count_wrong(solutions, answers);
+	report("non-coprime solve_all", time, wrong);
+	errors += wrong;
+
+	// 840 and 198 share 6, so one more on the first remainder can't agree
+	for (auto& system : systems) {
+		system[0] = (system[0] + 1) % shared[0];
+	}
+	time = time_it([&]() { solutions = non_coprime.solve_all(systems); });
+	wrong = 0;
+	for (const auto& solution : solutions) {
+		wrong += solution.has_value();
+	}
+	report("contradictions solve_all", time, wrong);
+	errors += wrong;
+
+	// lcm near 2^65
+	const crt_solver_t too_big({(size_t{1} << 61) - 1, 17});
+	if (too_big.modulus() != 0 || too_big.solve({5, 3}) || chinese_remainder({5, 3}, {(size_t{1} << 61) - 1, 17})) {
+		errors++;
+	}
+
+	if (errors != 0) {
+		report_error("crt_solver_t got {} wrong", errors);
+	}
+}
@@ -0,0 +1,165 @@
+/* Parallel shortest paths by delta-stepping
+ *
+ * Whole distance fields from one source, over a random digit map and a
+ * random weighted graph_t, with delta_stepping on 1, 2, 4... threads up to
+ * the machine's cores, against serial Dijkstra (shortest_path_t with a
+ * dense store and radix heap). Verbose also sweeps delta on all cores,
+ * with the work each did (and, with SEARCH_COUNTERS, where it went).
+ */
+#include <algorithm>  // min, max
+#include <print>
+#include <random>
+#include <string>
+#include <thread>
+#include <utility>	// std::pair
+#include <vector>
+
+#include "bench.h"
+#include "charmap.h"
+#include "delta_stepping.h"
+#include "graph.h"
+#include "hash.h"
+#include "parallel.h"
+#include "shortest_path.h"
+
+/* Serial Dijkstra over the same edges, to check against and to beat;
+ * cost(u, v) is the weight edges() gives u -> v. */
+template <typename Edges, typename Cost>
+static std::vector<size_t> dijkstra_field(size_t nodes, size_t source, const Edges& edges, const Cost& cost) {
+	auto search = make_shortest_path<size_t>(
+		[&](size_t u, auto&& emit) { edges(u, [&](size_t v, size_t) { emit(v); }); }, cost,
+		make_dense_store<size_t>(nodes, [](size_t u) { return u; }));
+	search.run(source, [](size_t) { return false; });
+
+	std::vector<size_t> field(nodes);
+	for (size_t u = 0; u < nodes; u++) {
+		field[u] = search.distance(u);
+	}
+	return field;
+}
+
+/* One line of the delta sweep */
+static void print_sweep(const duration_t& time, size_t delta, [[maybe_unused]] const search_stats_t& stats) {
+	std::print("{:>30} ({:>10.4f}ms) delta {}, {} relaxed, {} improved\n", "", time.count(), delta, stats.expanded,
+			   stats.pushed);
+#if defined(SEARCH_COUNTERS)
+	std::print("{:>30} {} taken ({} stale), {} edges, {} frontier at most, {:.1f} MB\n", "", stats.pops, stats.stale,
+			   stats.relaxed, stats.max_queue, static_cast<double>(stats.peak_bytes) / 1e6);
+#endif
+}
+
+/* Run delta_stepping on 1, 2, 4... threads; each result must match expected. */
+template <typename Run>
+static void bench_scaling(const std::string& label, const std::vector<size_t>& expected, Run&& run) {
+	const size_t cores = std::max<size_t>(1, std::thread::hardware_concurrency());
+	for (size_t threads = 1;; threads = std::min(threads * 2, cores)) {
+		thread_pool_t pool(threads);
+		std::vector<size_t> field;
+		auto time = time_it([&]() { field = run(pool); });
+		report(label + " " + std::to_string(threads) + " thread" + (threads == 1 ? "" : "s"), time, field[field.size() / 2]);
+
+		if (field != expected) {
+			report_error("{} on {} threads differs from Dijkstra", label, threads);
+		}
+		if (threads == cores) {
+			break;
+		}
+	}
+}
+
+static void bench_delta_grid(size_t side, bool verbose) {
+	std::mt19937_64 rng(2025);
+	std::uniform_int_distribution<int> digit('1', '9');
+
+	charmap_t map;
+	for (size_t y = 0; y < side; y++) {
+		std::string row(side, '1');
+		for (char& ch : row) {
+			ch = static_cast<char>(digit(rng));
+		}
+		map.add_line(row);
+	}
+
+	const point_t source(static_cast<dimension_t>(side / 2), static_cast<dimension_t>(side / 2));
+	const size_t s = side / 2 * side + side / 2;
+	auto tile_cost = [&](size_t v) { return static_cast<size_t>(map.data[v / side][v % side] - '0'); };
+	auto edges = [&](size_t u, auto&& relax) {
+		const size_t x = u % side;
+		const size_t y = u / side;
+		if (x > 0) {
+			relax(u - 1, tile_cost(u - 1));
+		}
+		if (x + 1 < side) {
+			relax(u + 1, tile_cost(u + 1));
+		}
+		if (y > 0) {
+			relax(u - side, tile_cost(u - side));
+		}
+		if (y + 1 < side) {
+			relax(u + side, tile_cost(u + side));
+		}
+	};
+
+	const std::string label = std::to_string(side) + "^2";
+	std::vector<size_t> expected;
+	auto cost = [&](size_t, size_t v) { return tile_cost(v); };
+	auto time = time_it([&]() { expected = dijkstra_field(side * side, s, edges, cost); });
+	report(label + " dijkstra", time, expected[expected.size() / 2]);
+
+	bench_scaling(label + " delta 16", expected, [&](thread_pool_t& pool) { return delta_stepping(map, source, 16, pool); });
+
+	if (verbose) {
+		for (size_t delta : {1zu, 4zu, 9zu, 32zu, 128zu, 1024zu}) {
+			search_stats_t stats;
+			time = time_it([&]() { delta_stepping(map, source, delta, thread_pool_t::shared(), &stats); });
+			print_sweep(time, delta, stats);
+		}
+	}
+}
+
+static void bench_delta_graph(size_t n, bool verbose) {
+	// n nodes, 4 random edges each, weights 1..100 from the ends
+	std::mt19937_64 rng(2025);
+	std::uniform_int_distribution<node_t> node(0, static_cast<node_t>(n - 1));
+	std::vector<std::pair<node_t, node_t>> pairs;
+	pairs.reserve(n * 4);
+	for (node_t u = 0; u < n; u++) {
+		for (size_t e = 0; e < 4; e++) {
+			pairs.push_back({u, node(rng)});
+		}
+	}
+	const graph_t graph = graph_t::from_edges(n, pairs);
+	auto weight = [](node_t u, node_t v) { return 1 + hash_values(u, v) % 100; };
+
+	auto edges = [&](size_t u, auto&& relax) {
+		for (node_t v : graph.neighbors(static_cast<node_t>(u))) {
+			relax(v, weight(static_cast<node_t>(u), v));
+		}
+	};
+
+	const std::string label = "graph " + std::to_string(n);
+	std::vector<size_t> expected;
+	auto cost = [&](size_t u, size_t v) { return weight(static_cast<node_t>(u), static_cast<node_t>(v)); };
+	auto time = time_it([&]() { expected = dijkstra_field(n, 0, edges, cost); });
+	report(label + " dijkstra", time, expected[expected.size() / 2]);
+
+	bench_scaling(label + " delta 64", expected, [&](thread_pool_t& pool) { return delta_stepping(graph, 0, weight, 64, pool); });
+
+	if (verbose) {
+		for (size_t delta : {1zu, 16zu, 64zu, 256zu, 1024zu}) {
+			search_stats_t stats;
+			time = time_it([&]() { delta_stepping(graph, 0, weight, delta, thread_pool_t::shared(), &stats); });
+			print_sweep(time, delta, stats);
+		}
+	}
+}
+
+void bench_delta(size_t n, bool verbose) {
+	size_t side = 1;
+	while ((side + 1) * (side + 1) <= n) {
+		side++;
+	}
+
+	bench_delta_grid(side, verbose);
+	bench_delta_graph(n, verbose);
+}
@@ -0,0 +1,323 @@
+/* Shortest paths on digit weighted grids
+ *
+ * Random maps of digits 1-9 (default_cost), from a quarter to three
+ * quarters of the way across the middle row; corner to corner every
+ * search covers the whole map whatever it does. The map
+ * based search is the old dijkstra(), states and predecessors kept in
+ * std::map; it only gets a small map. grid_dijkstra_t runs on both, with
+ * each of its queues; the steps cost at most 9, so dial_queue_t fits.
+ * A* (Manhattan distance, at least 1 per step) and the bidirectional
+ * search find the same costs; the open map of all 1s is where A*'s
+ * estimate is exact, the maze (corridors of 1 between walls of 9) where
+ * it is worst. The generic shortest_path_t runs the same search over
+ * packed_vector_t states with a dense and a hash store.
+ */
+#include <algorithm>  // min, clamp
+#include <cmath>	   // sqrt
+#include <map>
+#include <print>
+#include <queue>
+#include <random>
+#include <string>
+#include <utility>	// std::pair
+#include <vector>
+
+#include "bench.h"
+#include "charmap.h"
+#include "dijkstra.h"
+#include "shortest_path.h"
+#include "vector.h"
+
+static charmap_t digit_map(size_t side, std::mt19937_64& rng, char highest = '9') {
+	std::uniform_int_distribution<int> digit('1', highest);
+
+	charmap_t map;
+	for (size_t y = 0; y < side; y++) {
+		std::string row(side, '1');
+		for (char& ch : row) {
+			ch = static_cast<char>(digit(rng));
+		}
+		map.add_line(row);
+	}
+	return map;
+}
+
+/* Corridors of 1s carved through 9s by a random depth first walk over the
+ * odd tiles; a maze with a single route, but walls can be crossed at a price. */
+static charmap_t maze_map(size_t side, std::mt19937_64& rng) {
+	std::vector<std::string> rows(side, std::string(side, '9'));
+	const size_t cells = side / 2;
+
+	std::vector<std::pair<size_t, size_t>> stack = {{0, 0}};
+	rows[1][1] = '1';
+	while (!stack.empty()) {
+		auto [cx, cy] = stack.back();
+
+		std::pair<size_t, size_t> next[4];
+		size_t count = 0;
+		if (cx > 0 && rows[2 * cy + 1][2 * cx - 1] == '9') next[count++] = {cx - 1, cy};
+		if (cx + 1 < cells && rows[2 * cy + 1][2 * cx + 3] == '9') next[count++] = {cx + 1, cy};
+		if (cy > 0 && rows[2 * cy - 1][2 * cx + 1] == '9') next[count++] = {cx, cy - 1};
+		if (cy + 1 < cells && rows[2 * cy + 3][2 * cx + 1] == '9') next[count++] = {cx, cy + 1};
+
+		if (count == 0) {
+			stack.pop_back();
+			continue;
+		}
+
+		auto [nx, ny] = next[rng() % count];
+		rows[cy + ny + 1][cx + nx + 1] = '1';  // the wall between
+		rows[2 * ny + 1][2 * nx + 1] = '1';
+		stack.push_back({nx, ny});
+	}
+
+	charmap_t map;
+	for (const auto& row : rows) {
+		map.add_line(row);
+	}
+	return map;
+}
+
+/* dijkstra() as it was, on std::map; cost only. */
+static size_t map_dijkstra(const charmap_t& map, const vector_t& start, const point_t& end, size_t& expanded) {
+	dist_t dist;
+	pred_t pred;
+	std::priority_queue<vector_t, std::vector<vector_t>, compare_cost> Q;
+
+	Q.push(start);
+	dist[start] = 0;
+	while (!Q.empty()) {
+		vector_t u = Q.top();
+		Q.pop();
+		expanded++;
+
+		size_t cost = static_cast<size_t>(u.p.z);
+		u.p.z = 0;
+		if (u.p == end) {
+			return cost;
+		}
+
+		von_neumann_t::for_each([&](const offset_t& direction) {
+			vector_t v(u.p + direction, direction);
+			if (map.is_valid(v.p)) {
+				size_t neighbor_cost = default_cost(cost, u, v, map);
+				auto dit = dist.find(v);
+				if (dit == dist.end() || neighbor_cost < dit->second) {
+					dist[v] = neighbor_cost;
+					pred[v].clear();
+					pred[v].emplace_back(u);
+					v.p.z = static_cast<dimension_t>(neighbor_cost);
+					Q.push(v);
+				} else if (neighbor_cost == dit->second) {
+					pred[v].emplace_back(u);
+				}
+			}
+		});
+	}
+	return INT_MAX;
+}
+
+/* What the counters saw, when built with SEARCH_COUNTERS (make COUNTERS=1) */
+static void print_counters([[maybe_unused]] const search_stats_t& stats) {
+#if defined(SEARCH_COUNTERS)
+	std::print("{:>30} {} pops ({} stale), {} relaxed, {} queued at most, {:.1f} MB\n", "", stats.pops, stats.stale,
+			   stats.relaxed, stats.max_queue, static_cast<double>(stats.peak_bytes) / 1e6);
+#endif
+}
+
+static void bench_grid(const std::string& name, const charmap_t& map, bool with_map, bool verbose) {
+	const vector_t start(point_t(map.size_x / 4, map.size_y / 2), point_t(0, 0));
+	const point_t end(3 * map.size_x / 4, map.size_y / 2);
+
+	if (with_map) {
+		size_t expanded = 0;
+		size_t cost = 0;
+		auto time = time_it([&]() { cost = map_dijkstra(map, start, end, expanded); });
+		report(name + " std::map", time, cost);
+		if (verbose) {
+			std::print("{:>30} {} states, {:.1f}ns each\n", "", expanded, time.count() * 1'000'000.0 / static_cast<double>(expanded));
+		}
+	}
+
+	const std::pair<const char*, queue_kind_t> queues[] = {
+		{"binary", queue_kind_t::binary},
+		{"dial", queue_kind_t::dial},
+		{"radix", queue_kind_t::radix},
+	};
+
+	grid_dijkstra_t<> search(map);
+	for (const auto& [queue_name, queue] : queues) {
+		size_t cost = 0;
+		auto time = time_it([&]() { cost = search.run(start, end, nullptr, 9, queue); });
+		report(name + " grid_dijkstra_t " + queue_name, time, cost);
+		if (verbose) {
+			std::print("{:>30} {} states, {:.1f}ns each\n", "", search.stats.expanded, search.stats.ns_per_node());
+			print_counters(search.stats);
+		}
+	}
+	const size_t dijkstra_expanded = search.stats.expanded;
+
+	// the shortest path DAG the last run left behind
+	size_t tiles = 0;
+	auto time = time_it([&]() { tiles = search.count_path_tiles(end); });
+	report(name + " tiles on any path", time, tiles);
+
+	size_t paths = 0;
+	time = time_it([&]() { paths = search.count_paths(end); });
+	report(name + " count paths", time, paths);
+
+	auto expanded = [&]() {
+		if (verbose) {
+			std::print("{:>30} {} states ({:.1f}% of dijkstra), {:.1f}ns each\n", "", search.stats.expanded,
+					   100.0 * static_cast<double>(search.stats.expanded) / static_cast<double>(dijkstra_expanded),
+					   search.stats.ns_per_node());
+			print_counters(search.stats);
+		}
+	};
+
+	size_t cost = 0;
+	time = time_it([&]() { cost = search.astar(start, end, manhattan_heuristic_t{1}, nullptr, 9); });
+	report(name + " grid_dijkstra_t astar", time, cost);
+	expanded();
+
+	time = time_it([&]() { cost = search.bidirectional(start, end, nullptr, 9); });
+	report(name + " grid_dijkstra_t bidirectional", time, cost);
+	expanded();
+}
+
+/* grid_dijkstra_t's search through shortest_path_t; packed (x, y, heading) states. */
+static void bench_generic(const std::string& name, const charmap_t& map, bool verbose) {
+	const packed_vector_t start(map.size_x / 4, map.size_y / 2);
+	const dimension_t end_x = 3 * map.size_x / 4;
+	const dimension_t end_y = map.size_y / 2;
+
+	auto neighbors = [&](const packed_vector_t& s, auto&& emit) {
+		von_neumann_t::for_each([&](const offset_t& step) {
+			const dimension_t x = s.x() + step.dx;
+			const dimension_t y = s.y() + step.dy;
+			if (map.is_valid(x, y)) {
+				emit(packed_vector_t(x, y, static_cast<unsigned>(compass_t::index_of(step.dx, step.dy))));
+			}
+		});
+	};
+	auto cost = [&](const packed_vector_t&, const packed_vector_t& to) {
+		return static_cast<size_t>(map.get(to.x(), to.y()) - '0');
+	};
+	auto is_end = [&](const packed_vector_t& s) { return s.x() == end_x && s.y() == end_y; };
+
+	const auto width = static_cast<size_t>(map.size_x);
+	auto index = [width](const packed_vector_t& s) {
+		return (static_cast<size_t>(s.y()) * width + static_cast<size_t>(s.x())) * (packed_vector_t::directions + 1) + s.heading();
+	};
+	const size_t states = width * static_cast<size_t>(map.size_y) * (packed_vector_t::directions + 1);
+
+	auto dense = make_shortest_path<packed_vector_t>(neighbors, cost, make_dense_store<packed_vector_t>(states, index));
+	size_t result = 0;
+	auto time = time_it([&]() { result = dense.run(start, is_end); });
+	report(name + " shortest_path_t dense", time, result);
+	if (verbose) {
+		std::print("{:>30} {} states, {:.1f}ns each\n", "", dense.stats.expanded, dense.stats.ns_per_node());
+		print_counters(dense.stats);
+	}
+
+	auto hashed = make_shortest_path<packed_vector_t>(neighbors, cost);
+	time = time_it([&]() { result = hashed.run(start, is_end); });
+	report(name + " shortest_path_t hash", time, result);
+	if (verbose) {
+		std::print("{:>30} {} states, {:.1f}ns each\n", "", hashed.stats.expanded, hashed.stats.ns_per_node());
+		print_counters(hashed.stats);
+	}
+}
+
+/* Many short queries on one map: a new grid_dijkstra_t for each (allocating
+ * and filling every array) against one kept as a workspace, then the
+ * nearest of several target sets in one search and a multi-source field. */
+static void bench_batch(const std::string& name, const charmap_t& map, std::mt19937_64& rng, bool verbose) {
+	const size_t queries = 200;
+	std::uniform_int_distribution<dimension_t> x(0, map.size_x - 1);
+	std::uniform_int_distribution<dimension_t> y(0, map.size_y - 1);
+	std::uniform_int_distribution<dimension_t> near(-10, 10);
+
+	std::vector<std::pair<vector_t, point_t>> pairs;
+	for (size_t i = 0; i < queries; i++) {
+		point_t s(x(rng), y(rng));
+		point_t e(std::clamp<dimension_t>(s.x + near(rng), 0, map.size_x - 1), std::clamp<dimension_t>(s.y + near(rng), 0, map.size_y - 1));
+		pairs.push_back({vector_t(s, point_t(0, 0)), e});
+	}
+
+	size_t total = 0;
+	auto time = time_it([&]() {
+		for (const auto& [start, end] : pairs) {
+			grid_dijkstra_t<> search(map);
+			total += search.run(start, end, nullptr, 9);
+		}
+	});
+	report(name + " " + std::to_string(queries) + " queries, new each", time, total);
+
+	grid_dijkstra_t<> workspace(map);
+	size_t reused = 0;
+	time = time_it([&]() {
+		for (const auto& [start, end] : pairs) {
+			reused += workspace.run(start, end, nullptr, 9);
+		}
+	});
+	report(name + " " + std::to_string(queries) + " queries, workspace", time, reused);
+
+	// the nearest of each of 8 sets of 16 tiles, from 4 starts
+	std::vector<vector_t> starts;
+	for (size_t i = 0; i < 4; i++) {
+		starts.push_back(vector_t(point_t(x(rng), y(rng)), point_t(0, 0)));
+	}
+	std::vector<std::vector<point_t>> targets(8);
+	for (auto& set : targets) {
+		for (size_t i = 0; i < 16; i++) {
+			set.push_back(point_t(x(rng), y(rng)));
+		}
+	}
+
+	size_t separate = 0;
+	time = time_it([&]() {
+		for (const auto& set : targets) {
+			size_t nearest = SIZE_MAX;
+			for (const auto& p : set) {
+				nearest = std::min(nearest, workspace.run(starts, p, nullptr, 9));
+			}
+			separate += nearest;
+		}
+	});
+	report(name + " 8 target sets, one by one", time, separate);
+
+	size_t together = 0;
+	time = time_it([&]() {
+		for (size_t cost : workspace.run_to_targets(starts, targets, nullptr, 9)) {
+			together += cost;
+		}
+	});
+	report(name + " 8 target sets, run_to_targets", time, together);
+
+	std::vector<size_t> field;
+	time = time_it([&]() {
+		workspace.run_field(starts, nullptr, 9);
+		workspace.export_field(field);
+	});
+	report(name + " field from 4 starts", time, field[field.size() / 2]);
+	if (verbose) {
+		std::print("{:>30} {} states, {:.1f}ns each\n", "", workspace.stats.expanded, workspace.stats.ns_per_node());
+		print_counters(workspace.stats);
+	}
+}
+
+void bench_dijkstra(size_t n, bool verbose) {
+	std::mt19937_64 rng(2025);
+
+	const size_t side = std::min<size_t>(static_cast<size_t>(std::sqrt(static_cast<double>(n))), 2'000);
+	const size_t small = std::min<size_t>(side, 250);
+
+	bench_grid(std::to_string(small) + "^2", digit_map(small, rng), true, verbose);
+	const charmap_t digits = digit_map(side, rng);
+	bench_grid(std::to_string(side) + "^2", digits, false, verbose);
+	bench_generic(std::to_string(side) + "^2", digits, verbose);
+	bench_batch(std::to_string(side) + "^2", digits, rng, verbose);
+	bench_grid(std::to_string(side) + "^2 open", digit_map(side, rng, '1'), false, verbose);
+	bench_grid(std::to_string(side) + "^2 maze", maze_map(side | 1, rng), false, verbose);
+}
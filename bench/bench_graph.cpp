@@ -0,0 +1,223 @@
+/* Directed graphs as graph_t (compressed sparse row)
+ *
+ * Day 11's map<string, vector<string>> against parse_graph(), first reading
+ * "name: a b c" lines and then counting paths through a layered DAG, once
+ * by string lookups and once along graph_t's arrays. The recursive counts
+ * only get a small DAG; fold_dag() down a topological order counts paths
+ * through the whole one, and components are found on it with a cycle added.
+ * Ordering only what one node reaches must refuse that cycle but not one
+ * that can't be reached.
+ */
+#include <algorithm>  // min
+#include <cstdint>
+#include <map>
+#include <optional>
+#include <print>
+#include <random>
+#include <sstream>
+#include <string>
+#include <utility>	// std::pair, std::move
+#include <vector>
+
+#include "bench.h"
+#include "graph.h"
+
+using legacy_graph_t = std::map<std::string, std::vector<std::string>>;
+
+/* Five letter name for node i */
+static std::string node_name(size_t i) {
+	std::string name(5, 'a');
+	for (size_t k = 0; k < name.size(); k++) {
+		name[name.size() - 1 - k] = static_cast<char>('a' + i % 26);
+		i /= 26;
+	}
+	return name;
+}
+
+/* n nodes, each with 1 to 3 edges to nodes a little later on; the last
+ * node has no edges */
+static std::string dag_lines(size_t n, std::mt19937_64& rng) {
+	std::uniform_int_distribution<size_t> edges(1, 3);
+	std::uniform_int_distribution<size_t> ahead(1, 20);
+
+	std::string text;
+	text.reserve(n * 20);
+	for (size_t i = 0; i + 1 < n; i++) {
+		text += node_name(i);
+		text += ':';
+		for (size_t e = edges(rng); e > 0; e--) {
+			text += ' ';
+			text += node_name(std::min(n - 1, i + ahead(rng)));
+		}
+		text += '\n';
+	}
+
+	return text;
+}
+
+/* day 11 as it used to read its input */
+static legacy_graph_t legacy_read(const std::string& text) {
+	legacy_graph_t graph;
+	std::istringstream is(text);
+	std::string line;
+	while (std::getline(is, line)) {
+		std::istringstream words(line);
+		std::string name;
+		words >> name;
+		name.pop_back();  // ':'
+
+		auto& targets = graph[name];
+		std::string target;
+		while (words >> target) {
+			targets.push_back(target);
+		}
+	}
+	return graph;
+}
+
+static size_t legacy_count(const legacy_graph_t& graph, const std::string& from, const std::string& to,
+						   std::map<std::string, size_t>& cache) {
+	if (from == to) {
+		return 1;
+	}
+	if (auto it = cache.find(from); it != cache.end()) {
+		return it->second;
+	}
+
+	size_t paths = 0;
+	if (auto it = graph.find(from); it != graph.end()) {
+		for (const auto& next : it->second) {
+			paths += legacy_count(graph, next, to, cache);
+		}
+	}
+	cache[from] = paths;
+	return paths;
+}
+
+static size_t csr_count(const graph_t& graph, node_t from, node_t to, std::vector<size_t>& cache) {
+	if (from == to) {
+		return 1;
+	}
+	if (cache[from] != SIZE_MAX) {
+		return cache[from];
+	}
+
+	size_t paths = 0;
+	for (node_t next : graph.neighbors(from)) {
+		paths += csr_count(graph, next, to, cache);
+	}
+	cache[from] = paths;
+	return paths;
+}
+
+void bench_graph(size_t n, bool verbose) {
+	std::mt19937_64 rng(2025);
+	const std::string text = dag_lines(n, rng);
+	if (verbose) {
+		std::print("{} nodes, {} bytes\n", n, text.size());
+	}
+
+	legacy_graph_t legacy;
+	auto time = time_it([&]() { legacy = legacy_read(text); });
+	report("map<string, vector> read", time, legacy.size());
+
+	graph_t graph;
+	time = time_it([&]() { graph = parse_graph(text); });
+	report("parse_graph", time, graph.size());
+	if (verbose) {
+		std::print("{:>30} {:>10.1f} MB/s, {} edges\n", "", static_cast<double>(text.size()) / 1e3 / time.count(),
+				   graph.edge_count());
+	}
+
+	// every name back to its node, by view; nothing is allocated per lookup
+	size_t named = 0;
+	time = time_it([&]() {
+		for (node_t u = 0; u < graph.size(); u++) {
+			named += graph.id_of(graph.name_of(u)) == u;
+		}
+	});
+	report("graph_t id_of", time, named);
+	if (named != graph.size()) {
+		report_error("id_of(name_of(u)) != u for {} nodes", graph.size() - named);
+	}
+
+	graph_t reversed;
+	time = time_it([&]() { reversed = graph.reverse(); });
+	report("graph_t reverse", time, reversed.edge_count());
+
+	std::vector<node_t> order;
+	time = time_it([&]() { order = topological_order(graph); });
+	report("topological_order", time, order.size());
+
+	// ids are in the order names were first seen, not the order of the lines
+	const node_t source = graph.id_of(node_name(0));
+	const node_t sink = graph.id_of(node_name(n - 1));
+
+	// far more paths than fit; the count wraps (mod 2^64) and can come out 0
+	size_t paths = 0;
+	time = time_it([&]() {
+		std::vector<size_t> counts(graph.size(), 0);
+		counts[source] = 1;
+		counts = fold_dag(graph, order, std::move(counts), [](size_t& to, size_t from, node_t, node_t) { to += from; });
+		paths = counts[sink];
+	});
+	report("fold_dag count paths", time, paths);
+
+	// last back to first, so every node on a path between them is one component
+	std::vector<std::pair<node_t, node_t>> edges;
+	edges.reserve(graph.edge_count() + 1);
+	for (node_t u = 0; u < graph.size(); u++) {
+		for (node_t v : graph.neighbors(u)) {
+			edges.push_back({u, v});
+		}
+	}
+	edges.push_back({sink, source});
+	const graph_t cyclic = graph_t::from_edges(graph.size(), edges);
+
+	components_t components;
+	time = time_it([&]() { components = strongly_connected_components(cyclic); });
+	report("strongly_connected_components", time, components.count);
+
+	// from source, that cycle is reachable; one hanging off the side isn't
+	std::optional<std::vector<node_t>> reachable;
+	time = time_it([&]() { reachable = topological_order(graph, source); });
+	report("topological_order from source", time, reachable ? reachable->size() : 0);
+
+	edges.back() = {static_cast<node_t>(graph.size()), static_cast<node_t>(graph.size() + 1)};
+	edges.push_back({static_cast<node_t>(graph.size() + 1), static_cast<node_t>(graph.size())});
+	edges.push_back({static_cast<node_t>(graph.size() + 1), source});
+	const graph_t side_cycle = graph_t::from_edges(graph.size() + 2, edges);
+	const auto side_order = topological_order(side_cycle, source);
+	if (topological_order(cyclic, source) || !side_order || !reachable || side_order->size() != reachable->size()) {
+		report_error("topological_order from source got the reachable cycles wrong");
+	}
+
+	// both counts recurse as deep as the longest path; keep that to day 11 sizes
+	const size_t small_nodes = std::min<size_t>(n, 20'000);
+	const std::string small_text = dag_lines(small_nodes, rng);
+	legacy = legacy_read(small_text);
+	graph = parse_graph(small_text);
+
+	const std::string first = node_name(0);
+	const std::string last = node_name(small_nodes - 1);
+	time = time_it([&]() {
+		std::map<std::string, size_t> cache;
+		paths = legacy_count(legacy, first, last, cache);
+	});
+	report("map<string> count paths", time, paths);
+
+	time = time_it([&]() {
+		std::vector<size_t> cache(graph.size(), SIZE_MAX);
+		paths = csr_count(graph, graph.id_of(first), graph.id_of(last), cache);
+	});
+	report("graph_t count paths", time, paths);
+
+	time = time_it([&]() {
+		std::vector<size_t> counts(graph.size(), 0);
+		counts[graph.id_of(first)] = 1;
+		counts = fold_dag(graph, topological_order(graph), std::move(counts),
+						  [](size_t& to, size_t from, node_t, node_t) { to += from; });
+		paths = counts[graph.id_of(last)];
+	});
+	report("graph_t fold_dag count paths", time, paths);
+}
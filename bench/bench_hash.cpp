@@ -0,0 +1,140 @@
+/* Hash tables keyed on point_t
+ *
+ * Visited sets (insert + contains) and distance tables (operator[] updates)
+ * using flat_hash_set/map, std::unordered_set/map and std::set/map. The
+ * unordered set is also run with the old 16 bit masking hash to show why
+ * it was replaced.
+ */
+#include <map>
+#include <print>
+#include <random>
+#include <set>
+#include <string>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+
+#include "bench.h"
+#include "flat_hash.h"
+#include "point.h"
+
+/* The hash point_t used to have; x and y overlap and all are truncated to 16 bits. */
+struct legacy_point_hash {
+	size_t operator()(const point_t& p) const {
+		return std::hash<size_t>()(
+			  (((size_t)p.w & 0xFFFF) << 48)
+			| (((size_t)p.z & 0xFFFF) << 32)
+			| (((size_t)p.x & 0xFFFF) << 24)
+			| (((size_t)p.y & 0xFFFF)));
+	}
+};
+
+/* n points on a square grid around the origin, like a flood fill visits. */
+static std::vector<point_t> grid_points(size_t n) {
+	std::vector<point_t> points;
+	points.reserve(n);
+
+	dimension_t side = 1;
+	while (static_cast<size_t>(side * side) < n) {
+		side++;
+	}
+
+	for (dimension_t y = 0; y < side && points.size() < n; y++) {
+		for (dimension_t x = 0; x < side && points.size() < n; x++) {
+			points.emplace_back(x - side / 2, y - side / 2);
+		}
+	}
+
+	return points;
+}
+
+/* The grid again, spaced out 65536 apart; the old hash sends every one to the same bucket. */
+static std::vector<point_t> strided_points(size_t n) {
+	std::vector<point_t> points = grid_points(n);
+	for (auto& p : points) {
+		p.x *= 65536;
+		p.y *= 65536;
+	}
+
+	return points;
+}
+
+/* n points scattered over a large 3D space, including negative coordinates. */
+static std::vector<point_t> scattered_points(size_t n) {
+	std::mt19937_64 rng(2025);
+	std::uniform_int_distribution<dimension_t> coordinate(-1'000'000'000, 1'000'000'000);
+
+	std::vector<point_t> points;
+	points.reserve(n);
+	for (size_t i = 0; i < n; i++) {
+		points.emplace_back(coordinate(rng), coordinate(rng), coordinate(rng));
+	}
+
+	return points;
+}
+
+/* Insert every point then look each one up along with a shifted (mostly missing) copy. */
+template <typename Set>
+static void visited_set(const std::string& label, const std::vector<point_t>& points) {
+	size_t found = 0;
+	auto time = time_it([&]() {
+		Set visited;
+		for (const auto& p : points) {
+			visited.insert(p);
+		}
+
+		for (const auto& p : points) {
+			found += visited.count(p);
+			found += visited.count(p + point_t(1, 1, 1));
+		}
+	});
+
+	report(label, time, found);
+}
+
+/* Relax a distance for every point, several times, like a search's dist[] table. */
+template <typename Map>
+static void distance_table(const std::string& label, const std::vector<point_t>& points) {
+	size_t total = 0;
+	auto time = time_it([&]() {
+		Map dist;
+		for (size_t pass = 0; pass < 3; pass++) {
+			for (size_t i = 0; i < points.size(); i++) {
+				auto& d = dist[points[i]];
+				d = (d == 0 || i < d) ? i + pass : d;
+			}
+		}
+
+		for (const auto& [p, d] : dist) {
+			total += d;
+		}
+	});
+
+	report(label, time, total);
+}
+
+void bench_hash(size_t n, bool verbose) {
+	const std::vector<std::pair<std::string, std::vector<point_t>>> data_sets = {
+		{"grid", grid_points(n)},
+		{"strided", strided_points(n)},
+		{"scattered", scattered_points(n)},
+	};
+
+	for (const auto& [name, points] : data_sets) {
+		if (verbose) {
+			std::print("{} points ({})\n", points.size(), name);
+		}
+
+		visited_set<flat_hash_set<point_t>>(name + " flat_hash_set", points);
+		visited_set<std::unordered_set<point_t>>(name + " unordered_set", points);
+		// the old hash is quadratic on strided points, keep that to a size that finishes
+		if (name != "strided" || points.size() <= 20'000) {
+			visited_set<std::unordered_set<point_t, legacy_point_hash>>(name + " unordered_set (old)", points);
+		}
+		visited_set<std::set<point_t>>(name + " set", points);
+
+		distance_table<flat_hash_map<point_t, size_t>>(name + " flat_hash_map", points);
+		distance_table<std::unordered_map<point_t, size_t>>(name + " unordered_map", points);
+		distance_table<std::map<point_t, size_t>>(name + " map", points);
+	}
+}
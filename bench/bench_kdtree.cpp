@@ -0,0 +1,123 @@
+/* Nearest neighbours with kd_tree_t
+ *
+ * Random 3D points like day 8's junction boxes (coordinates up to 100,000):
+ * building the tree and every point's 4 nearest with all_nearest(). Against
+ * it, day 8's brute force (every pair's distance from point_cloud_t's
+ * for_each_pair, sorted shortest first, then read off point by point) on
+ * a set small enough for a quadratic loop; the rows must hold the same
+ * distances. within() is checked against the same pairs, and the rows
+ * all_nearest() leaves short when there are fewer than k other points.
+ */
+#include <algorithm>  // min
+#include <cstdint>
+#include <print>
+#include <random>
+#include <utility>	// std::pair
+#include <vector>
+
+#include "bench.h"
+#include "kd_tree.h"
+#include "point.h"
+#include "point_cloud.h"
+#include "radix_sort.h"
+
+using tree_t = kd_tree_t<3, int32_t>;
+using connection_t = std::pair<uint64_t, std::pair<uint32_t, uint32_t>>;
+
+static std::vector<point3i_t> random_points(size_t n, std::mt19937_64& rng) {
+	std::uniform_int_distribution<int32_t> coordinate(0, 100'000);
+	std::vector<point3i_t> points;
+	points.reserve(n);
+	for (size_t i = 0; i < n; i++) {
+		points.emplace_back(coordinate(rng), coordinate(rng), coordinate(rng));
+	}
+	return points;
+}
+
+/* day 8's point_distances(); every pair, shortest first */
+static std::vector<connection_t> all_pairs(const std::vector<point3i_t>& points) {
+	const point_cloud_t cloud = point_cloud_t::from_points(points);
+	std::vector<connection_t> distances;
+	distances.reserve(cloud.size() * (cloud.size() - 1) / 2);
+	cloud.for_each_pair([&](size_t i, size_t j, uint64_t distance) {
+		distances.push_back({distance, {static_cast<uint32_t>(i), static_cast<uint32_t>(j)}});
+	});
+	radix_sort_by_first(distances);
+	return distances;
+}
+
+void bench_kdtree(size_t n, bool verbose) {
+	constexpr size_t k = 4;
+	std::mt19937_64 rng(2025);
+
+	const std::vector<point3i_t> points = random_points(n, rng);
+	tree_t tree;
+	auto time = time_it([&]() { tree = tree_t(points); });
+	report("kd_tree_t build", time, tree.size());
+
+	std::vector<tree_t::neighbor_t> nearest;
+	time = time_it([&]() { nearest = tree.all_nearest(k); });
+	report("kd_tree_t all_nearest 4", time, static_cast<size_t>(nearest[k * (n / 2)].first));
+	if (verbose) {
+		std::print("{:>30} {} threads\n", "", thread_pool_t::shared().size());
+	}
+
+	// the brute force is quadratic; a few thousand points is plenty
+	const size_t small = std::min<size_t>(n, 3'000);
+	const std::vector<point3i_t> few = random_points(small, rng);
+
+	std::vector<connection_t> pairs;
+	time = time_it([&]() { pairs = all_pairs(few); });
+	report("day 8 all pairs, sorted", time, pairs.size());
+
+	std::vector<std::vector<uint64_t>> rows(small);
+	time = time_it([&]() {
+		for (const auto& [distance, ends] : pairs) {
+			if (rows[ends.first].size() < k) {
+				rows[ends.first].push_back(distance);
+			}
+			if (rows[ends.second].size() < k) {
+				rows[ends.second].push_back(distance);
+			}
+		}
+	});
+	report("day 8 nearest 4 from pairs", time, static_cast<size_t>(rows[small / 2].front()));
+
+	const tree_t few_tree(few);
+	time = time_it([&]() { nearest = few_tree.all_nearest(k); });
+	report("kd_tree_t nearest 4, same", time, static_cast<size_t>(nearest[k * (small / 2)].first));
+
+	size_t wrong = 0;
+	for (size_t i = 0; i < small; i++) {
+		for (size_t j = 0; j < rows[i].size(); j++) {
+			wrong += static_cast<uint64_t>(nearest[i * k + j].first) != rows[i][j];
+		}
+	}
+
+	// within(): each point itself, plus every pair no further apart than the
+	// 1000th shortest
+	const uint64_t radius = pairs[std::min<size_t>(pairs.size(), 1000) - 1].first;
+	std::vector<size_t> inside(small, 1);
+	for (const auto& [distance, ends] : pairs) {
+		if (distance > radius) {
+			break;
+		}
+		inside[ends.first]++;
+		inside[ends.second]++;
+	}
+	for (size_t i = 0; i < small; i++) {
+		wrong += few_tree.within(few[i], static_cast<dimension_t>(radius)).size() != inside[i];
+	}
+
+	// three points, so each has two neighbours and two no_neighbor
+	const tree_t three(std::vector<point3i_t>(few.begin(), few.begin() + 3));
+	const auto short_rows = three.all_nearest(k);
+	for (size_t i = 0; i < 3; i++) {
+		wrong += short_rows[i * k + 1].second >= 3;
+		wrong += short_rows[i * k + 2] != tree_t::no_neighbor || short_rows[i * k + 3] != tree_t::no_neighbor;
+	}
+
+	if (wrong != 0) {
+		report_error("kd_tree_t differs from the brute force {} times", wrong);
+	}
+}
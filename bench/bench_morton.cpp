@@ -0,0 +1,134 @@
+/* Z-order with morton.h
+ *
+ * Encoding and decoding random coordinates, checked against the portable
+ * bit spreading (so a build with -mbmi2 or -march=native checks pdep/pext
+ * against it). Then morton_sort on 2D point_t and 3D point3i_t sets: the
+ * result must be a reordering of the input with codes that never go down.
+ * The path through the points in each order shows the locality Z-order
+ * buys over input order and over sorting by x then y.
+ */
+#include <algorithm>  // sort, min, max
+#include <cstdint>
+#include <print>
+#include <random>
+#include <vector>
+
+#include "bench.h"
+#include "morton.h"
+#include "point.h"
+
+/* Length (manhattan) of the path visiting points in the order given */
+template <typename C>
+static size_t path_length(const C& points) {
+	size_t length = 0;
+	for (size_t i = 1; i < points.size(); i++) {
+		length += static_cast<size_t>(manhattan_distance(point_t(points[i - 1]), point_t(points[i])));
+	}
+	return length;
+}
+
+/* Codes of points in order, relative to their bounding box (no shift needed
+ * for these spans); morton_sort got it right if they never go down. */
+template <size_t Dims, typename C>
+static bool in_z_order(const C& points) {
+	point_t lo = points[0];
+	for (const auto& q : points) {
+		point_t p = q;
+		lo = {std::min(lo.x, p.x), std::min(lo.y, p.y), std::min(lo.z, p.z)};
+	}
+
+	uint64_t last = 0;
+	for (const auto& q : points) {
+		uint64_t code = Dims == 2 ? morton_key(q, lo) : morton_key3(q, lo);
+		if (code < last) {
+			return false;
+		}
+		last = code;
+	}
+	return true;
+}
+
+static size_t check_round_trip(size_t n, std::mt19937_64& rng) {
+	std::uniform_int_distribution<uint32_t> any;
+	std::uniform_int_distribution<uint32_t> bits21(0, (1u << 21) - 1);
+
+	size_t wrong = 0;
+	for (size_t i = 0; i < n; i++) {
+		const uint32_t x = any(rng);
+		const uint32_t y = any(rng);
+		const uint64_t code = morton_encode(x, y);
+		wrong += code != (morton_spread2(x) | (morton_spread2(y) << 1));
+		wrong += morton_decode2(code) != std::pair(x, y);
+
+		const uint32_t a = bits21(rng);
+		const uint32_t b = bits21(rng);
+		const uint32_t c = bits21(rng);
+		const uint64_t code3 = morton_encode(a, b, c);
+		wrong += code3 != (morton_spread3(a) | (morton_spread3(b) << 1) | (morton_spread3(c) << 2));
+		wrong += morton_decode3(code3) != std::tuple(a, b, c);
+	}
+	return wrong;
+}
+
+void bench_morton(size_t n, bool verbose) {
+	std::mt19937_64 rng(2025);
+	if (verbose) {
+#if defined(__BMI2__)
+		std::print("pdep/pext (BMI2)\n");
+#else
+		std::print("shift and mask (no BMI2)\n");
+#endif
+	}
+
+	size_t wrong = 0;
+	auto time = time_it([&]() { wrong = check_round_trip(n, rng); });
+	report("encode/decode round trip", time, wrong);
+	size_t errors = wrong;
+
+	std::uniform_int_distribution<dimension_t> coordinate(-1'000'000, 1'000'000);
+	std::vector<point_t> points;
+	points.reserve(n);
+	for (size_t i = 0; i < n; i++) {
+		points.emplace_back(coordinate(rng), coordinate(rng));
+	}
+	size_t length = 0;
+	time = time_it([&]() { length = path_length(points); });
+	report("input order path", time, length);
+
+	auto by_row = points;
+	time = time_it([&]() {
+		std::sort(by_row.begin(), by_row.end(), [](const point_t& a, const point_t& b) {
+			return a.x != b.x ? a.x < b.x : a.y < b.y;
+		});
+	});
+	report("std::sort by x, y", time, path_length(by_row));
+
+	auto z = points;
+	time = time_it([&]() { morton_sort(z); });
+	report("morton_sort 2D", time, path_length(z));
+
+	auto sorted = z;
+	std::sort(sorted.begin(), sorted.end());
+	std::sort(points.begin(), points.end());
+	errors += !in_z_order<2>(z) || sorted != points;
+
+	std::uniform_int_distribution<int32_t> coordinate3(-100'000, 100'000);
+	std::vector<point3i_t> points3;
+	points3.reserve(n);
+	for (size_t i = 0; i < n; i++) {
+		points3.emplace_back(coordinate3(rng), coordinate3(rng), coordinate3(rng));
+	}
+
+	auto z3 = points3;
+	time = time_it([&]() { morton_sort<3>(z3); });
+	report("morton_sort 3D", time, path_length(z3));
+
+	auto sorted3 = z3;
+	std::sort(sorted3.begin(), sorted3.end());
+	std::sort(points3.begin(), points3.end());
+	errors += !in_z_order<3>(z3) || sorted3 != points3;
+
+	if (errors != 0) {
+		report_error("morton codes or order wrong ({})", errors);
+	}
+}
@@ -0,0 +1,108 @@
+/* map(), filter() and reduce() from mrf.h
+ *
+ * The same map -> filter -> reduce chain three ways: the old versions
+ * (std::function stages, sources taken by value, a vector between each
+ * stage), the templated ones (any callable, still a vector between
+ * stages) and pipeline(), which fuses the chain into one loop. Once over
+ * numbers and once over words, where the copies cost the most.
+ */
+#include <algorithm>  // transform, copy_if
+#include <cstdint>
+#include <functional>
+#include <iterator>	// back_inserter
+#include <numeric>	// accumulate
+#include <print>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "bench.h"
+#include "mrf.h"
+
+/* mrf.h as it was */
+template <typename T, typename R>
+static R legacy_reduce(const std::vector<T> vec, const R start, std::function<R(T, R)> func) {
+	return std::accumulate(vec.begin(), vec.end(), start, func);
+}
+
+template <typename T, typename R>
+static std::vector<R> legacy_map(const std::vector<T>& src, const std::function<R(const T&)> func) {
+	std::vector<R> dst;
+	dst.reserve(src.size());
+	std::transform(src.begin(), src.end(), std::back_inserter(dst), func);
+	return dst;
+}
+
+template <typename T>
+static std::vector<T> legacy_filter(const std::vector<T> src, const std::function<bool(const T&)> func) {
+	std::vector<T> filtered;
+	std::copy_if(src.begin(), src.end(), std::back_inserter(filtered), func);
+	return filtered;
+}
+
+static void bench_numbers(size_t n) {
+	std::mt19937_64 rng(2025);
+	std::vector<uint64_t> numbers(n);
+	for (auto& x : numbers) {
+		x = rng() % 1'000'000;
+	}
+
+	auto square = [](const uint64_t& x) { return x * x % 1'000'003; };
+	auto is_even = [](const uint64_t& x) { return x % 2 == 0; };
+	auto add = [](uint64_t accum, uint64_t x) { return accum + x; };
+
+	uint64_t total = 0;
+	auto time = time_it([&]() {
+		auto squares = legacy_map<uint64_t, uint64_t>(numbers, square);
+		auto even = legacy_filter<uint64_t>(squares, is_even);
+		total = legacy_reduce<uint64_t, uint64_t>(even, 0, add);
+	});
+	report("numbers std::function", time, total);
+
+	time = time_it([&]() { total = reduce(filter(map(numbers, square), is_even), uint64_t{0}, add); });
+	report("numbers templates", time, total);
+
+	time = time_it([&]() { total = pipeline(numbers).map(square).filter(is_even).reduce(uint64_t{0}, add); });
+	report("numbers pipeline", time, total);
+}
+
+static void bench_words(size_t n) {
+	std::mt19937_64 rng(2025);
+	std::uniform_int_distribution<size_t> length(4, 24);
+	std::uniform_int_distribution<int> letter('a', 'z');
+	std::vector<std::string> words(n);
+	for (auto& word : words) {
+		word.resize(length(rng));
+		for (char& ch : word) {
+			ch = static_cast<char>(letter(rng));
+		}
+	}
+
+	// words past 'm', how long they are, summed
+	auto late = [](const std::string& word) { return word[0] > 'm'; };
+	auto size = [](const std::string& word) { return word.size(); };
+	auto add = [](size_t accum, size_t x) { return accum + x; };
+
+	size_t total = 0;
+	auto time = time_it([&]() {
+		auto kept = legacy_filter<std::string>(words, late);
+		auto sizes = legacy_map<std::string, size_t>(kept, size);
+		total = legacy_reduce<size_t, size_t>(sizes, 0, add);
+	});
+	report("words std::function", time, total);
+
+	time = time_it([&]() { total = reduce(map(filter(words, late), size), size_t{0}, add); });
+	report("words templates", time, total);
+
+	time = time_it([&]() { total = pipeline(words).filter(late).map(size).reduce(size_t{0}, add); });
+	report("words pipeline", time, total);
+}
+
+void bench_mrf(size_t n, bool verbose) {
+	if (verbose) {
+		std::print("{} numbers and {} words\n", n, n);
+	}
+
+	bench_numbers(n);
+	bench_words(n);
+}
@@ -0,0 +1,124 @@
+/* Parsing one point per line
+ *
+ * The old point_t::from_string (vector + stol(substr)) against the
+ * allocation-free scanner through read_points(), and parse_points() into
+ * vector<point_t>, vector<point3i_t> and point_cloud_t, from memory and
+ * from a memory mapped file.
+ */
+#include <filesystem>
+#include <fstream>
+#include <print>
+#include <random>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include "bench.h"
+#include "mapped_file.h"
+#include "point.h"
+#include "point_cloud.h"
+#include "point_parser.h"
+
+/* point_t::from_string as it used to be. */
+static point_t legacy_from_string(const std::string& str) {
+	const std::string digits{"-0123456789"};
+	std::vector<long> result;
+
+	size_t start = str.find_first_of(digits, 0);
+	size_t end = str.find_first_not_of(digits, start);
+	while (start != std::string::npos) {
+		result.push_back(std::stol(str.substr(start)));
+
+		start = str.find_first_of(digits, end);
+		end = str.find_first_not_of(digits, start);
+	}
+
+	return {result};
+}
+
+/* n lines of "x,y,z", coordinates in +/- one million */
+static std::string point_lines(size_t n) {
+	std::mt19937_64 rng(2025);
+	std::uniform_int_distribution<long> coordinate(-1'000'000, 1'000'000);
+
+	std::string text;
+	text.reserve(n * 24);
+	for (size_t i = 0; i < n; i++) {
+		text += std::to_string(coordinate(rng));
+		text += ',';
+		text += std::to_string(coordinate(rng));
+		text += ',';
+		text += std::to_string(coordinate(rng));
+		text += '\n';
+	}
+
+	return text;
+}
+
+/* report, plus MB/s when verbose */
+static void report_rate(const std::string& label, duration_t time, size_t points, size_t bytes, bool verbose) {
+	report(label, time, points);
+	if (verbose) {
+		std::print("{:>30} {:>10.1f} MB/s\n", "", static_cast<double>(bytes) / 1e3 / time.count());
+	}
+}
+
+void bench_parse(size_t n, bool verbose) {
+	const std::string text = point_lines(n);
+	if (verbose) {
+		std::print("{} lines, {} bytes\n", n, text.size());
+	}
+
+	{
+		std::vector<point_t> points;
+		auto time = time_it([&]() {
+			std::istringstream is(text);
+			std::string line;
+			while (std::getline(is, line)) {
+				points.push_back(legacy_from_string(line));
+			}
+		});
+		report_rate("getline old from_string", time, points.size(), text.size(), verbose);
+	}
+
+	{
+		std::vector<point_t> points;
+		auto time = time_it([&]() {
+			std::istringstream is(text);
+			points = read_points(is);
+		});
+		report_rate("read_points", time, points.size(), text.size(), verbose);
+	}
+
+	{
+		std::vector<point_t> points;
+		auto time = time_it([&]() { parse_points(text, points); });
+		report_rate("parse_points point_t", time, points.size(), text.size(), verbose);
+	}
+
+	{
+		std::vector<point3i_t> points;
+		auto time = time_it([&]() { parse_points(text, points); });
+		report_rate("parse_points point3i_t", time, points.size(), text.size(), verbose);
+	}
+
+	{
+		point_cloud_t cloud;
+		auto time = time_it([&]() { parse_points(text, cloud); });
+		report_rate("parse_points point_cloud_t", time, cloud.size(), text.size(), verbose);
+	}
+
+	{
+		auto file_name = std::filesystem::temp_directory_path() / "bench_points.txt";
+		std::ofstream(file_name) << text;
+
+		point_cloud_t cloud;
+		auto time = time_it([&]() {
+			mapped_file_t file(file_name.string());
+			parse_points(file.view(), cloud);
+		});
+		report_rate("mapped_file point_cloud_t", time, cloud.size(), text.size(), verbose);
+
+		std::filesystem::remove(file_name);
+	}
+}
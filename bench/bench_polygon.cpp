@@ -0,0 +1,140 @@
+/* Box-in-polygon queries against a large rectilinear polygon
+ *
+ * A "skyline" polygon of random width and height columns (like day 9's
+ * tiles, but with tens of thousands of vertices) and random boxes. The
+ * linear version walks every edge for every box; polygon_index_t answers
+ * from its merge sort trees. The linear walk only gets a sample of the
+ * boxes, it would take hours on all of them.
+ */
+#include <algorithm>  // min, max
+#include <print>
+#include <random>
+#include <vector>
+
+#include "bench.h"
+#include "point.h"
+#include "polygon_index.h"
+
+/* Vertices of a skyline with columns / 2 columns; (0, 0), up and across each column, back down. */
+static std::vector<point_t> skyline(size_t vertices, std::mt19937_64& rng) {
+	std::uniform_int_distribution<dimension_t> width(1, 1000);
+	std::uniform_int_distribution<dimension_t> height(1, 1'000'000);
+
+	std::vector<point_t> polygon;
+	polygon.reserve(vertices + 2);
+	polygon.emplace_back(0, 0);
+
+	dimension_t x = 0;
+	for (size_t i = 0; i < vertices / 2; i++) {
+		dimension_t h = height(rng);
+		polygon.emplace_back(x, h);
+		x += width(rng);
+		polygon.emplace_back(x, h);
+	}
+
+	polygon.emplace_back(x, 0);
+	return polygon;
+}
+
+/* Box inside check by walking every edge: no edge through the box's interior,
+ * and its centre inside by ray casting. Edges are one unit apart at the
+ * least, so the doubled centre never lands ambiguously. */
+static bool linear_contains_box(const std::vector<point_t>& polygon, const point_t& a, const point_t& b) {
+	const dimension_t x1 = std::min(a.x, b.x);
+	const dimension_t x2 = std::max(a.x, b.x);
+	const dimension_t y1 = std::min(a.y, b.y);
+	const dimension_t y2 = std::max(a.y, b.y);
+
+	const dimension_t cx = x1 + x2;	 // doubled
+	const dimension_t cy = y1 + y2;
+	bool inside = false;
+
+	for (size_t i = 0; i < polygon.size(); i++) {
+		const point_t& p = polygon[i];
+		const point_t& q = polygon[(i + 1) % polygon.size()];
+
+		if (p.y == q.y) {
+			if (y1 < p.y && p.y < y2 && std::min(p.x, q.x) < x2 && std::max(p.x, q.x) > x1) {
+				return false;
+			}
+			if (cy == 2 * p.y && 2 * std::min(p.x, q.x) <= cx && cx <= 2 * std::max(p.x, q.x)) {
+				return true;  // centre on the boundary
+			}
+		} else {
+			if (x1 < p.x && p.x < x2 && std::min(p.y, q.y) < y2 && std::max(p.y, q.y) > y1) {
+				return false;
+			}
+			if (2 * p.x > cx && 2 * std::min(p.y, q.y) <= cy && cy < 2 * std::max(p.y, q.y)) {
+				inside = !inside;
+			}
+		}
+	}
+
+	return inside;
+}
+
+void bench_polygon(size_t n, bool verbose) {
+	std::mt19937_64 rng(2025);
+
+	const size_t vertices = std::min<size_t>(n, 50'000);
+	const auto polygon = skyline(vertices, rng);
+	const dimension_t width = polygon.back().x;
+
+	// boxes around random spots on the skyline, mostly small, some inside
+	std::uniform_int_distribution<dimension_t> x(0, width);
+	std::uniform_int_distribution<dimension_t> y(0, 1'000'000);
+	std::uniform_int_distribution<dimension_t> size(0, 5'000);
+	std::vector<std::pair<point_t, point_t>> boxes;
+	boxes.reserve(n);
+	for (size_t i = 0; i < n; i++) {
+		point_t a(x(rng), y(rng));
+		boxes.emplace_back(a, point_t(a.x + size(rng), a.y + size(rng)));
+	}
+
+	if (verbose) {
+		std::print("{} vertices, {} boxes\n", polygon.size(), boxes.size());
+	}
+
+	const size_t sample = std::min<size_t>(n, 1'000);
+	size_t linear_inside = 0;
+	auto time = time_it([&]() {
+		for (size_t i = 0; i < sample; i++) {
+			linear_inside += linear_contains_box(polygon, boxes[i].first, boxes[i].second) ? 1u : 0u;
+		}
+	});
+	report("linear (sample)", time, linear_inside);
+	if (verbose) {
+		std::print("{:>30} {:>10.4f}us per box\n", "", time.count() * 1000.0 / static_cast<double>(sample));
+	}
+
+	polygon_index_t index;
+	time = time_it([&]() { index = polygon_index_t(polygon); });
+	report("polygon_index_t build", time, index.size());
+
+	size_t sample_inside = 0;
+	for (size_t i = 0; i < sample; i++) {
+		sample_inside += index.contains_box(boxes[i].first, boxes[i].second) ? 1u : 0u;
+	}
+	if (sample_inside != linear_inside) {
+		report_error("index found {} boxes inside, linear {}", sample_inside, linear_inside);
+	}
+
+	size_t inside = 0;
+	time = time_it([&]() {
+		for (const auto& [a, b] : boxes) {
+			inside += index.contains_box(a, b) ? 1u : 0u;
+		}
+	});
+	report("polygon_index_t contains_box", time, inside);
+	if (verbose) {
+		std::print("{:>30} {:>10.4f}us per box\n", "", time.count() * 1000.0 / static_cast<double>(boxes.size()));
+	}
+
+	size_t points_inside = 0;
+	time = time_it([&]() {
+		for (const auto& [a, b] : boxes) {
+			points_inside += index.contains(a) ? 1u : 0u;
+		}
+	});
+	report("polygon_index_t contains", time, points_inside);
+}
@@ -0,0 +1,84 @@
+/* Filling a large polygon
+ *
+ * A rectilinear "skyline" and a general (diagonal edged) polygon spanning
+ * 100,000 x 100,000 tiles, counted with Pick's theorem, the scanline
+ * raster_t and (rectilinear only) compressed_grid_t. A charmap_t flood
+ * fill would need 10^10 bytes; none of these come close.
+ */
+#include <algorithm>  // min, max
+#include <cmath>	   // cos, sin
+#include <string>
+#include <print>
+#include <random>
+#include <vector>
+
+#include "bench.h"
+#include "point.h"
+#include "raster.h"
+
+constexpr dimension_t extent = 100'000;
+
+/* Skyline of columns random width and height across [0, extent]. */
+static std::vector<point_t> skyline(size_t columns, std::mt19937_64& rng) {
+	std::uniform_int_distribution<dimension_t> height(1, extent);
+
+	std::vector<point_t> polygon;
+	polygon.emplace_back(0, 0);
+
+	const dimension_t width = std::max<dimension_t>(1, extent / static_cast<dimension_t>(columns));
+	for (dimension_t x = 0; x + width <= extent; x += width) {
+		dimension_t h = height(rng);
+		polygon.emplace_back(x, h);
+		polygon.emplace_back(x + width, h);
+	}
+
+	polygon.emplace_back(polygon.back().x, 0);
+	return polygon;
+}
+
+/* A star shaped polygon around the centre; vertices at increasing angles. */
+static std::vector<point_t> star(size_t vertices, std::mt19937_64& rng) {
+	std::uniform_real_distribution<double> radius(0.2, 0.5);
+
+	std::vector<point_t> polygon;
+	const double pi = 3.14159265358979323846;
+	for (size_t i = 0; i < vertices; i++) {
+		double angle = 2 * pi * static_cast<double>(i) / static_cast<double>(vertices);
+		double r = radius(rng) * extent;
+		polygon.emplace_back(static_cast<dimension_t>(extent / 2 + r * std::cos(angle)),
+							 static_cast<dimension_t>(extent / 2 + r * std::sin(angle)));
+	}
+
+	return polygon;
+}
+
+static void bench_polygon_fill(const std::string& name, const std::vector<point_t>& polygon, bool compressed, bool verbose) {
+	if (verbose) {
+		std::print("{}: {} vertices\n", name, polygon.size());
+	}
+
+	dimension_t pick = 0;
+	auto time = time_it([&]() { pick = covered_points(polygon); });
+	report(name + " covered_points", time, static_cast<size_t>(pick));
+
+	raster_t raster;
+	time = time_it([&]() { raster = raster_t::from_polygon(polygon); });
+	report(name + " raster_t", time, raster.count());
+
+	if (compressed) {
+		compressed_grid_t grid;
+		time = time_it([&]() { grid = compressed_grid_t::from_polygon(polygon); });
+		report(name + " compressed_grid_t", time, grid.count());
+		if (verbose) {
+			std::print("{:>30} {} x {} cells\n", "", grid.width, grid.height);
+		}
+	}
+}
+
+void bench_raster(size_t n, bool verbose) {
+	std::mt19937_64 rng(2025);
+
+	const size_t vertices = std::min<size_t>(n, 2'000);
+	bench_polygon_fill("skyline", skyline(vertices / 2, rng), true, verbose);
+	bench_polygon_fill("star", star(vertices, rng), false, verbose);
+}
@@ -0,0 +1,131 @@
+/* Sorting with radix_sort.h
+ *
+ * Points through point_t::operator< against radix_sort_points, and day 8's
+ * pair distances (key and payload) inserted into a std::map against
+ * std::sort and radix_sort_by_first. The parallel radix sort runs on the
+ * shared thread pool, then nested in a loop on a busy pool and alongside
+ * another caller. First checks that thread_pool_t::run_on_all still calls
+ * every index when nested.
+ */
+#include <algorithm>  // sort, count
+#include <atomic>
+#include <map>
+#include <print>
+#include <random>
+#include <thread>
+#include <utility>	// std::pair
+#include <vector>
+
+#include "bench.h"
+#include "parallel.h"
+#include "point.h"
+#include "radix_sort.h"
+
+using keyed_t = std::pair<uint64_t, std::pair<uint32_t, uint32_t>>;
+
+static void bench_sort_points(size_t n, std::mt19937_64& rng) {
+	std::uniform_int_distribution<dimension_t> coordinate(-1'000'000, 1'000'000);
+	std::vector<point_t> points;
+	points.reserve(n);
+	for (size_t i = 0; i < n; i++) {
+		points.emplace_back(coordinate(rng), coordinate(rng), coordinate(rng));
+	}
+
+	auto sorted = points;
+	auto time = time_it([&]() { std::sort(sorted.begin(), sorted.end()); });
+	report("std::sort points", time, static_cast<size_t>(sorted[n / 2].x));
+
+	auto radix = points;
+	time = time_it([&]() { radix_sort_points(radix); });
+	report("radix_sort_points", time, static_cast<size_t>(radix[n / 2].x));
+
+	if (!std::equal(sorted.begin(), sorted.end(), radix.begin())) {
+		report_error("radix_sort_points order differs from std::sort");
+	}
+}
+
+static void bench_sort_keyed(size_t n, bool verbose, std::mt19937_64& rng) {
+	std::uniform_int_distribution<uint64_t> distance(0, uint64_t{1} << 40);
+	std::vector<keyed_t> pairs;
+	pairs.reserve(n);
+	for (uint32_t i = 0; i < n; i++) {
+		pairs.push_back({distance(rng), {i, i + 1}});
+	}
+
+	std::map<uint64_t, std::pair<uint32_t, uint32_t>> map;
+	auto time = time_it([&]() {
+		for (const auto& [key, value] : pairs) {
+			map[key] = value;
+		}
+	});
+	report("std::map insert", time, map.begin()->second.first);
+
+	auto sorted = pairs;
+	time = time_it([&]() {
+		std::sort(sorted.begin(), sorted.end(), [](const keyed_t& a, const keyed_t& b) { return a.first < b.first; });
+	});
+	report("std::sort pairs", time, sorted.front().second.first);
+
+	auto radix = pairs;
+	time = time_it([&]() { radix_sort_by_first(radix); });
+	report("radix_sort_by_first", time, radix.front().second.first);
+
+	thread_pool_t& pool = thread_pool_t::shared();
+	auto parallel = pairs;
+	time = time_it([&]() { parallel_radix_sort_by(parallel, pool, [](const keyed_t& p) { return p.first; }); });
+	report("parallel_radix_sort_by", time, parallel.front().second.first);
+	if (verbose) {
+		std::print("{:>30} {} threads\n", "", pool.size());
+	}
+
+	if (radix != parallel) {
+		report_error("parallel radix sort differs from radix sort");
+	}
+
+	// from inside a loop body on the same (busy) pool, and from another thread
+	// while that loop runs; four threads so the pool is shared on any machine
+	thread_pool_t busy(4);
+	std::vector<keyed_t> nested[2] = {pairs, pairs};
+	auto concurrent = pairs;
+	time = time_it([&]() {
+		std::thread other([&]() { parallel_radix_sort_by(concurrent, busy, [](const keyed_t& p) { return p.first; }); });
+		busy.parallel_for(2, [&](size_t begin, size_t end) {
+			for (size_t i = begin; i < end; i++) {
+				parallel_radix_sort_by(nested[i], busy, [](const keyed_t& p) { return p.first; });
+			}
+		}, 1);
+		other.join();
+	});
+	report("parallel_radix_sort_by nested", time, nested[0].front().second.first);
+
+	if (nested[0] != radix || nested[1] != radix || concurrent != radix) {
+		report_error("nested parallel radix sort differs from radix sort");
+	}
+}
+
+/* run_on_all from inside a loop body on the same pool (so the pool is busy)
+ * must still call every index, or loops split by pool.size() lose chunks.
+ * Its own four threads, so the busy path is taken on any machine. */
+static void check_nested_pool() {
+	thread_pool_t pool(4);
+	std::atomic<size_t> missing = 0;
+	pool.parallel_for(pool.size() * 4, [&](size_t begin, size_t end) {
+		for (size_t i = begin; i < end; i++) {
+			std::vector<char> seen(pool.size(), 0);
+			pool.run_on_all([&](size_t t) { seen[t] = 1; });
+			missing += static_cast<size_t>(std::count(seen.begin(), seen.end(), 0));
+		}
+	}, 1);
+
+	if (missing != 0) {
+		report_error("nested run_on_all skipped {} thread indexes", missing.load());
+	}
+}
+
+void bench_sort(size_t n, bool verbose) {
+	std::mt19937_64 rng(2025);
+
+	check_nested_pool();
+	bench_sort_points(n, rng);
+	bench_sort_keyed(n, verbose, rng);
+}
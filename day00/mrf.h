@@ -1,12 +1,18 @@
+#if !defined(MRF_H)
+#define MRF_H
+
 /* map(), reduce(), and filter() meta-functions */
-#include <algorithm>  // sort
-#include <functional>
-#include <ranges>  // ranges and views
-#include <vector>  // collection
-
-/* Reduce vector of U to single T using func */
-template <typename T, typename R>
-R reduce(const std::vector<T> vec, const R start, std::function<R(T, R)> func) {
+#include <algorithm>	// transform, copy_if
+#include <cstddef>
+#include <iterator>		// back_inserter
+#include <numeric>		// accumulate
+#include <type_traits>	// conditional_t, invoke_result_t
+#include <utility>		// std::move, std::forward
+#include <vector>		// collection
+
+/* Reduce vector of T to single R using func(accum, value) */
+template <typename T, typename R, typename F>
+R reduce(const std::vector<T>& vec, const R start, F func) {
 	return std::accumulate(vec.begin(), vec.end(), start, func);
 }
 
@@ -18,16 +24,18 @@ R reduce(const std::vector<T> vec, const R start, std::function<R(T, R)> func) {
  *
  *	size_t add_pass(const size_t accum, const string &pass) { return accum + ...; }
  *
- * The use the reduce passing the function, make sure to include the types!
+ * The use the reduce passing the function (any callable; the types can be
+ * left for the compiler to work out):
  *
- *	auto total = reduce<string, size_t>(passes, 0, add_pass);
+ *	auto total = reduce(passes, size_t{0}, add_pass);
  */
 
-/* Map vector of S to vector of D using func */
-template <typename T, typename R>
-std::vector<R> map(const std::vector<T>& src,
-				   const std::function<R(const T&)> func) {
-	std::vector<R> dst;
+/* Map vector of T to vector of R using func; R defaults to what func returns */
+template <typename T, typename R = void, typename F>
+auto map(const std::vector<T>& src, F func) {
+	using out_t = std::conditional_t<std::is_void_v<R>, std::invoke_result_t<F&, const T&>, R>;
+
+	std::vector<out_t> dst;
 	dst.reserve(src.size());
 	std::transform(src.begin(), src.end(), std::back_inserter(dst), func);
 	return dst;
@@ -39,15 +47,14 @@ std::vector<R> map(const std::vector<T>& src,
  *
  *	size_t decode_pass(const string &pass) { return 0; }
  *
- * The use the map passing the function, make sure to include the types!
+ * The use the map passing the function:
  *
- *	auto seats = map<string, size_t>(passes, decode_pass);
+ *	auto seats = map(passes, decode_pass);	// or map<string, size_t>(...)
  */
 
 /* filter vector to a new vector for all that match func. */
-template <typename T>
-std::vector<T> filter(const std::vector<T> src,
-					  const std::function<bool(const T&)> func) {
+template <typename T, typename F>
+std::vector<T> filter(const std::vector<T>& src, F func) {
 	std::vector<T> filtered;
 	std::copy_if(src.begin(), src.end(), std::back_inserter(filtered), func);
 	return filtered;
@@ -55,11 +62,93 @@ std::vector<T> filter(const std::vector<T> src,
 
 /* Example using filter()
  *
- *	auto possible = filter<instruction_t>(program, [](const instruction_t &instr) {
+ *	auto possible = filter(program, [](const instruction_t &instr) {
  *		return instr.op != "acc";
  *	});
  */
 
+/* Lazy map/filter chains run as one loop. Each of map() and filter() wraps
+ * the stages before it and hands values on to the next, nothing is stored
+ * between stages, and the whole chain is one type the compiler can inline.
+ * Nothing runs until reduce(), count(), for_each() or to_vector().
+ *
+ * The pipeline holds a reference to the source vector, so finish it while
+ * the vector is still around (in the same statement is simplest). A
+ * temporary vector won't compile; it would be gone before the chain runs.
+ *
+ *	size_t total = pipeline(passes)
+ *		.map(decode_pass)
+ *		.filter([](size_t seat) { return seat > 8; })
+ *		.reduce(size_t{0}, [](size_t accum, size_t seat) { return accum + seat; });
+ */
+template <typename T, typename Value, typename Stage>
+class pipeline_t {
+   public:
+	pipeline_t(const std::vector<T>& source, Stage stage) : _source(source), _stage(std::move(stage)) {}
+
+	template <typename F>
+	auto map(F func) const {
+		auto stage = [stage = _stage, func](const T& value, auto&& sink) {
+			stage(value, [&](auto&& x) { sink(func(std::forward<decltype(x)>(x))); });
+		};
+		return pipeline_t<T, std::invoke_result_t<const F&, Value>, decltype(stage)>(_source, std::move(stage));
+	}
+
+	template <typename F>
+	auto filter(F func) const {
+		auto stage = [stage = _stage, func](const T& value, auto&& sink) {
+			stage(value, [&](auto&& x) {
+				if (func(x)) {
+					sink(std::forward<decltype(x)>(x));
+				}
+			});
+		};
+		return pipeline_t<T, Value, decltype(stage)>(_source, std::move(stage));
+	}
+
+	/* func(value) for everything coming out the end */
+	template <typename F>
+	void for_each(F func) const {
+		for (const T& value : _source) {
+			_stage(value, func);
+		}
+	}
+
+	/* Fold everything coming out the end with func(accum, value) */
+	template <typename R, typename F>
+	R reduce(R start, F func) const {
+		for_each([&](auto&& x) { start = func(std::move(start), std::forward<decltype(x)>(x)); });
+		return start;
+	}
+
+	size_t count() const {
+		size_t n = 0;
+		for_each([&](auto&&) { n++; });
+		return n;
+	}
+
+	auto to_vector() const {
+		std::vector<std::remove_cvref_t<Value>> dst;
+		for_each([&](auto&& x) { dst.push_back(std::forward<decltype(x)>(x)); });
+		return dst;
+	}
+
+   private:
+	const std::vector<T>& _source;
+	Stage _stage;
+};
+
+/* Start a pipeline over src */
+template <typename T>
+auto pipeline(const std::vector<T>& src) {
+	auto stage = [](const T& value, auto&& sink) { sink(value); };
+	return pipeline_t<T, const T&, decltype(stage)>(src, stage);
+}
+
+// pipeline(make_words()).map(f) would keep a reference to a dead vector
+template <typename T>
+auto pipeline(const std::vector<T>&&) = delete;
+
 /* Enumerate the vector V resulting in a vector of pairs (index, value)
  * 	using I as index type and V as value type
  */
@@ -74,10 +163,12 @@ std::vector<std::pair<I, V>> enumerate(const std::vector<V>& vec) {
 	return pairs;
 }
 
-/* Example of using enumerate 
+/* Example of using enumerate
 	std::vector<int> v = {1, 2, 3 };
 	auto e = enumerate<size_t, int>(v);
 
 	Now e will be a vector of pairs:
 		[ {0, 1}, {1, 2}, {2, 3} ]
-*/
\ No newline at end of file
+*/
+
+#endif
@@ -0,0 +1,67 @@
+#if !defined(NEIGHBORHOOD_H)
+#define NEIGHBORHOOD_H
+
+#include <array>
+#include <cstddef>
+
+#include "point.h"
+
+/* Grid neighbourhoods as compile time tables of steps.
+ *
+ * Pass one as a template parameter (charmap_t::neighbors_of<von_neumann_t>,
+ * dijkstra<moore_t>...) instead of carrying a vector of directions around;
+ * the table is shared, constexpr, and for_each() unrolls completely.
+ *
+ *	von_neumann_t	4 neighbours; (0,1), (1,0), (0,-1), (-1,0)
+ *	moore_t			8 neighbours; the 4 plus diagonals
+ *	stencil_t<...>	any other set of steps, e.g. knight moves
+ *		using knight_t = stencil_t<offset_t{1, 2}, offset_t{2, 1}, ...>;
+ */
+struct offset_t {
+	dimension_t dx = 0;
+	dimension_t dy = 0;
+
+	operator point_t() const { return {dx, dy}; }
+};
+
+template <offset_t... Steps>
+struct stencil_t {
+	static constexpr size_t size = sizeof...(Steps);
+	static constexpr std::array<offset_t, size> steps = {Steps...};
+
+	// index of (dx, dy) in steps, or size if it is not one of them
+	static constexpr size_t index_of(dimension_t dx, dimension_t dy) {
+		for (size_t i = 0; i < size; i++) {
+			if (steps[i].dx == dx && steps[i].dy == dy) {
+				return i;
+			}
+		}
+		return size;
+	}
+
+	static constexpr size_t index_of(const point_t& dir) {
+		return index_of(dir.x, dir.y);
+	}
+
+	// call fn(step) for each step, unrolled
+	template <typename F>
+	static constexpr void for_each(F&& fn) {
+		(fn(Steps), ...);
+	}
+
+	// call fn(index, step) for each step, unrolled
+	template <typename F>
+	static constexpr void for_each_indexed(F&& fn) {
+		size_t i = 0;
+		(fn(i++, Steps), ...);
+	}
+};
+
+using von_neumann_t = stencil_t<offset_t{0, 1}, offset_t{1, 0}, offset_t{0, -1}, offset_t{-1, 0}>;
+
+using moore_t = stencil_t<
+	offset_t{-1, -1}, offset_t{0, -1}, offset_t{1, -1},
+	offset_t{-1, 0},                   offset_t{1, 0},
+	offset_t{-1, 1},  offset_t{0, 1},  offset_t{1, 1}>;
+
+#endif
@@ -37,7 +37,7 @@ const auto accessible_bales(const data_t& data) {
 	 * Does it have fewer than four (4) neighboring rolls of paper '@'?
 	 */
 	const auto can_access = [&data](const point_t& p) {
-		auto n =  ranges::count_if(data.neighbors_of(p), [](const auto &pr) { return pr.second == '@'; });
+		auto n = data.count_neighbors(p, '@');
 		return n < 4;
 	};
 
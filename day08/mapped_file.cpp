@@ -0,0 +1,46 @@
+#include "mapped_file.h"
+
+#include <fcntl.h>	   // open
+#include <sys/mman.h>  // mmap, munmap
+#include <sys/stat.h>  // fstat
+#include <unistd.h>	   // close
+
+#include <fstream>	 // ifstream (fallback)
+#include <iterator>	 // istreambuf_iterator
+
+mapped_file_t::mapped_file_t(const std::string& file_name) {
+	int fd = ::open(file_name.c_str(), O_RDONLY);
+	if (fd < 0) {
+		return;
+	}
+
+	struct stat st = {};
+	if (::fstat(fd, &st) == 0 && S_ISREG(st.st_mode) && st.st_size > 0) {
+		void* data = ::mmap(nullptr, static_cast<size_t>(st.st_size), PROT_READ, MAP_PRIVATE, fd, 0);
+		if (data != MAP_FAILED) {
+			_data = static_cast<const char*>(data);
+			_size = static_cast<size_t>(st.st_size);
+			_mapped = true;
+			_open = true;
+#if defined(MADV_SEQUENTIAL)
+			::madvise(data, _size, MADV_SEQUENTIAL);
+#endif
+		}
+	}
+	::close(fd);
+
+	if (!_mapped) {
+		// not something we can map, read it the ordinary way
+		std::ifstream ifs(file_name, std::ios::binary);
+		_open = ifs.good();
+		_contents.assign(std::istreambuf_iterator<char>(ifs), std::istreambuf_iterator<char>());
+		_data = _contents.data();
+		_size = _contents.size();
+	}
+}
+
+mapped_file_t::~mapped_file_t() {
+	if (_mapped) {
+		::munmap(const_cast<char*>(_data), _size);
+	}
+}
@@ -0,0 +1,63 @@
+#if !defined(PARALLEL_H)
+#define PARALLEL_H
+
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <functional>  // std::function
+#include <mutex>
+#include <thread>
+#include <vector>
+
+/* A fixed set of worker threads for splitting loops across cores.
+ *
+ * parallel_for() hands out chunks of [0, n) to the workers and the calling
+ * thread, and returns once every chunk is done. Only one loop runs at a time;
+ * calling parallel_for() from inside a loop body runs the inner loop serially.
+ *
+ *	thread_pool_t::shared().parallel_for(points.size(), [&](size_t begin, size_t end) {
+ *		for (size_t i = begin; i < end; i++) { ... }
+ *	});
+ */
+class thread_pool_t {
+   public:
+	// threads counts the caller, so thread_pool_t(1) runs everything inline
+	explicit thread_pool_t(size_t threads = std::thread::hardware_concurrency());
+	~thread_pool_t();
+
+	thread_pool_t(const thread_pool_t&) = delete;
+	thread_pool_t& operator=(const thread_pool_t&) = delete;
+
+	size_t size() const { return _workers.size() + 1; }
+
+	/* Call fn(begin, end) over chunks covering [0, n); grain is the chunk
+	 * size (0 picks one that gives each thread several chunks). */
+	void parallel_for(size_t n, const std::function<void(size_t begin, size_t end)>& fn, size_t grain = 0);
+
+	/* Call fn(thread_index) once for each index 0..size()-1, for per-thread
+	 * setup or loops that partition the work themselves. Normally each index
+	 * runs on its own thread; if the pool is already busy (called from inside
+	 * a loop body, or from another thread) they all run on the caller, one
+	 * after another. */
+	void run_on_all(const std::function<void(size_t thread_index)>& fn);
+
+	// process-wide pool sized to the machine
+	static thread_pool_t& shared();
+
+   private:
+	std::vector<std::thread> _workers = {};
+	std::mutex _mutex = {};
+	std::condition_variable _wake = {};
+	std::condition_variable _done = {};
+
+	// current job, guarded by _mutex
+	const std::function<void(size_t)>* _job = nullptr;
+	size_t _generation = 0;
+	size_t _running = 0;
+	bool _stopping = false;
+	bool _busy = false;
+
+	void worker(size_t thread_index);
+};
+
+#endif
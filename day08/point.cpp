@@ -43,6 +43,11 @@ std::istream& operator>>(std::istream& is, point_t& p) {
 /* Read points, one per line from istream until end of file or empty line.
  * optionally, call callback function to modify point before being emplaced.
  * gets copy of the line/string used to create the point for use.
+ *
+ * Still getline: the stream has to be left just past the empty line for
+ * the next section, and fn wants the line. Each line is scanned without
+ * allocating (from_string) into one reused buffer; with the whole text in
+ * memory, parse_points() is the faster way.
  */
 std::vector<point_t> read_points(std::istream& is, void (*fn)(point_t& point, const std::string& line)) {
 	std::vector<point_t> points;
@@ -1,17 +1,61 @@
 #if !defined(POINT_T_H)
 #define POINT_T_H
 
+#include <compare>
 #include <concepts>
+#include <cstdint>
 #include <iomanip>	 // setw and setprecision on output
 #include <iostream>	 // cout
+#include <limits>
 #include <string>	 // std::string
+#include <string_view>
 #include <tuple>
+#include <type_traits>
 #include <vector>
 #include <cassert>
 
+#include "hash.h"
+
 using dimension_t = long;
 using value_t = long;
 
+/* Scan up to max_values signed integers out of str into values, skipping
+ * anything that is not part of a number. Returns how many were found.
+ * Numbers too big for value_t saturate at its limits. No allocation and no
+ * copies; used for every point parsed from text. */
+inline size_t scan_integers(std::string_view str, value_t* values, size_t max_values) {
+	auto is_digit = [](char ch) { return '0' <= ch && ch <= '9'; };
+
+	size_t count = 0;
+	const char* p = str.data();
+	const char* end = p + str.size();
+	while (p < end && count < max_values) {
+		bool negative = *p == '-' && p + 1 < end && is_digit(p[1]);
+		if (!negative && !is_digit(*p)) {
+			p++;
+			continue;
+		}
+
+		if (negative) {
+			p++;
+		}
+
+		// unsigned, so the most negative value fits and nothing overflows
+		constexpr uint64_t most = std::numeric_limits<value_t>::max();
+		const uint64_t limit = negative ? most + 1 : most;
+		uint64_t magnitude = 0;
+		while (p < end && is_digit(*p)) {
+			const auto digit = static_cast<uint64_t>(*p - '0');
+			magnitude = magnitude <= (limit - digit) / 10 ? magnitude * 10 + digit : limit;
+			p++;
+		}
+
+		values[count++] = negative ? static_cast<value_t>(0 - magnitude) : static_cast<value_t>(magnitude);
+	}
+
+	return count;
+}
+
 struct point_t {
 	dimension_t x = 0;
 	dimension_t y = 0;
@@ -140,12 +184,7 @@ struct point_t {
 	}
 
 	bool operator!=(const point_t& other) const {
-		// return !(*this == other);
-		return this->x != other.x 
-			|| this->y != other.y 
-			|| this->z != other.z
-			|| this->w != other.w;
-
+		return !(*this == other);
 	}
 
 	point_t& operator=(const point_t& other) {
@@ -190,24 +229,11 @@ struct point_t {
 		return lhs;	 // return the result by value (uses move constructor)
 	}
 
-	static point_t from_string(const std::string& str) {
-		auto split_numbers = [](const std::string& str) {
-			const std::string digits{"-0123456789"};
-			std::vector<long> result;
-
-			size_t start = str.find_first_of(digits, 0);
-			size_t end = str.find_first_not_of(digits, start);
-			while (start != std::string::npos) {
-				result.push_back(std::stol(str.substr(start)));
-
-				start = str.find_first_of(digits, end);
-				end = str.find_first_not_of(digits, start);
-			}
-
-			return result;
-		};
-
-		return {split_numbers(str)};
+	/* Point from the numbers in a string; "1,-2,3" or "x=1, y=-2, z=3" etc. */
+	static point_t from_string(std::string_view str) {
+		value_t v[4] = {0, 0, 0, 0};
+		scan_integers(str, v, 4);
+		return {v[0], v[1], v[2], v[3]};
 	}
 
 	friend struct std::formatter<point_t>;
@@ -217,15 +243,12 @@ std::ostream& operator<<(std::ostream& os, const point_t& p);
 std::ostream& operator<<(std::ostream& os, const std::vector<point_t>& v);
 std::istream& operator>>(std::istream& is, point_t& p);
 
-/* hash function so can be put in unordered_map or set */
+/* hash function so can be put in unordered_map or set
+ * mixes all of the coordinates, they do not overlap or get truncated */
 template <>
 struct std::hash<point_t> {
 	size_t operator()(const point_t& p) const {
-		return std::hash<size_t>()(
-			  (((size_t)p.w & 0xFFFF) << 48)
-			| (((size_t)p.z & 0xFFFF) << 32) 
-			| (((size_t)p.x & 0xFFFF) << 24) 
-			| (((size_t)p.y & 0xFFFF)));
+		return hash_values(p.x, p.y, p.z, p.w);
 	}
 };
 
@@ -261,6 +284,184 @@ inline dimension_t manhattan_distance(const point_t& p1, const point_t& p2) {
 	return dx + dy + dz + dw;
 }
 
+/* Compact point types; point<N, T> has N coordinates of type T and nothing
+ * else, so it stays trivially copyable and packs tightly into vectors.
+ * 	point<2, int32_t> is 8 bytes, point<3, int32_t> is 12 bytes vs 40 for point_t
+ *
+ * Always sorts by x, then y, then z, then w; there is no feature_z_sort flag.
+ * Convert from point_t explicitly (it may narrow) and back to point_t implicitly.
+ */
+template <size_t N, typename T>
+struct point_storage;
+
+template <typename T>
+struct point_storage<2, T> {
+	T x = 0;
+	T y = 0;
+
+	constexpr T& operator[](size_t i) { return i == 0 ? x : y; }
+	constexpr const T& operator[](size_t i) const { return i == 0 ? x : y; }
+	constexpr auto operator<=>(const point_storage&) const = default;
+};
+
+template <typename T>
+struct point_storage<3, T> {
+	T x = 0;
+	T y = 0;
+	T z = 0;
+
+	constexpr T& operator[](size_t i) { return i == 0 ? x : i == 1 ? y : z; }
+	constexpr const T& operator[](size_t i) const { return i == 0 ? x : i == 1 ? y : z; }
+	constexpr auto operator<=>(const point_storage&) const = default;
+};
+
+template <typename T>
+struct point_storage<4, T> {
+	T x = 0;
+	T y = 0;
+	T z = 0;
+	T w = 0;
+
+	constexpr T& operator[](size_t i) { return i == 0 ? x : i == 1 ? y : i == 2 ? z : w; }
+	constexpr const T& operator[](size_t i) const { return i == 0 ? x : i == 1 ? y : i == 2 ? z : w; }
+	constexpr auto operator<=>(const point_storage&) const = default;
+};
+
+/* From converts to To without narrowing (as braces would allow) */
+template <typename From, typename To>
+concept non_narrowing_to = requires(From from) { To{from}; };
+
+template <size_t N, typename T>
+struct point : point_storage<N, T> {
+	static_assert(std::is_integral_v<T> && std::is_signed_v<T>, "point coordinates are signed integers");
+
+	using coordinate_t = T;
+	static constexpr size_t dimensions = N;
+
+	constexpr point() = default;
+
+	// only from types that fit in T, so point2i_t p = {5'000'000'000L, 0}
+	// does not compile; cast first to truncate on purpose
+	template <non_narrowing_to<T>... Ts>
+		requires(sizeof...(Ts) == N)
+	constexpr point(Ts... coordinates) {
+		size_t i = 0;
+		(((*this)[i++] = static_cast<T>(coordinates)), ...);
+	}
+
+	// narrowing, so must be asked for; takes the first N coordinates of p
+	constexpr explicit point(const point_t& p) {
+		const dimension_t from[4] = {p.x, p.y, p.z, p.w};
+		for (size_t i = 0; i < N; i++) {
+			(*this)[i] = static_cast<T>(from[i]);
+		}
+	}
+
+	operator point_t() const {
+		dimension_t to[4] = {0, 0, 0, 0};
+		for (size_t i = 0; i < N; i++) {
+			to[i] = static_cast<dimension_t>((*this)[i]);
+		}
+		return {to[0], to[1], to[2], to[3]};
+	}
+
+	constexpr auto operator<=>(const point&) const = default;
+
+	constexpr point& operator+=(const point& rhs) {
+		for (size_t i = 0; i < N; i++) {
+			(*this)[i] = static_cast<T>((*this)[i] + rhs[i]);
+		}
+		return *this;
+	}
+
+	friend constexpr point operator+(point lhs, const point& rhs) {
+		lhs += rhs;
+		return lhs;
+	}
+
+	constexpr point& operator-=(const point& rhs) {
+		for (size_t i = 0; i < N; i++) {
+			(*this)[i] = static_cast<T>((*this)[i] - rhs[i]);
+		}
+		return *this;
+	}
+
+	friend constexpr point operator-(point lhs, const point& rhs) {
+		lhs -= rhs;
+		return lhs;
+	}
+};
+
+using point2i_t = point<2, int32_t>;
+using point3i_t = point<3, int32_t>;
+using point3l_t = point<3, int64_t>;
+
+static_assert(std::is_trivially_copyable_v<point2i_t> && sizeof(point2i_t) == 8);
+static_assert(std::is_trivially_copyable_v<point3i_t> && sizeof(point3i_t) == 12);
+static_assert(std::is_trivially_copyable_v<point3l_t> && sizeof(point3l_t) == 24);
+
+template <size_t N, typename T>
+struct std::hash<point<N, T>> {
+	size_t operator()(const point<N, T>& p) const {
+		uint64_t h = 0;
+		for (size_t i = 0; i < N; i++) {
+			h = hash_combine(h, static_cast<uint64_t>(p[i]));
+		}
+		return static_cast<size_t>(h);
+	}
+};
+
+template <size_t N, typename T>
+std::ostream& operator<<(std::ostream& os, const point<N, T>& p) {
+	os << "(" << p[0];
+	for (size_t i = 1; i < N; i++) {
+		os << "," << p[i];
+	}
+	os << ")";
+	return os;
+}
+
+template <size_t N, typename T>
+struct std::formatter<point<N, T>> {
+	constexpr auto parse(std::format_parse_context& context) {
+		return context.begin();
+	}
+
+	auto format(const point<N, T>& p, std::format_context& context) const {
+		auto out = context.out();
+
+		std::format_to(out, "({}", p[0]);
+		for (size_t i = 1; i < N; i++) {
+			std::format_to(out, ",{}", p[i]);
+		}
+		std::format_to(out, ")");
+
+		return out;
+	}
+};
+
+/* Squared euclidean distance, computed in dimension_t so int32_t coordinates
+ * do not overflow when squared. */
+template <size_t N, typename T>
+constexpr dimension_t sq_distance(const point<N, T>& p1, const point<N, T>& p2) {
+	dimension_t distance = 0;
+	for (size_t i = 0; i < N; i++) {
+		dimension_t d = static_cast<dimension_t>(p1[i]) - static_cast<dimension_t>(p2[i]);
+		distance += d * d;
+	}
+	return distance;
+}
+
+template <size_t N, typename T>
+constexpr dimension_t manhattan_distance(const point<N, T>& p1, const point<N, T>& p2) {
+	dimension_t distance = 0;
+	for (size_t i = 0; i < N; i++) {
+		dimension_t d = static_cast<dimension_t>(p1[i]) - static_cast<dimension_t>(p2[i]);
+		distance += d < 0 ? -d : d;
+	}
+	return distance;
+}
+
 // read points until we hit an empty line
 std::vector<point_t> read_points(std::istream& is, void (*fn)(point_t& point, const std::string& line) = nullptr);
 
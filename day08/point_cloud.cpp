@@ -0,0 +1,84 @@
+#include "point_cloud.h"
+
+#include <algorithm>  // min, max
+#include <cassert>
+#include <limits>
+#include <memory>  // assume_aligned
+
+#if defined(__AVX2__)
+#include <immintrin.h>
+#endif
+
+/* One point against a run of n points; the inner loop of every kernel below.
+ * Coordinates are widened to 64 bits before squaring. */
+static void sq_distances_run(const int32_t* __restrict xs, const int32_t* __restrict ys,
+							 const int32_t* __restrict zs, size_t n,
+							 int32_t px, int32_t py, int32_t pz,
+							 uint64_t* __restrict out) {
+	size_t i = 0;
+
+#if defined(__AVX2__)
+	// 4 points per step; widen to 64 bit lanes then square the low 32 bits
+	const __m256i vx = _mm256_set1_epi64x(px);
+	const __m256i vy = _mm256_set1_epi64x(py);
+	const __m256i vz = _mm256_set1_epi64x(pz);
+	for (; i + 4 <= n; i += 4) {
+		__m256i dx = _mm256_sub_epi64(_mm256_cvtepi32_epi64(_mm_loadu_si128(reinterpret_cast<const __m128i*>(xs + i))), vx);
+		__m256i dy = _mm256_sub_epi64(_mm256_cvtepi32_epi64(_mm_loadu_si128(reinterpret_cast<const __m128i*>(ys + i))), vy);
+		__m256i dz = _mm256_sub_epi64(_mm256_cvtepi32_epi64(_mm_loadu_si128(reinterpret_cast<const __m128i*>(zs + i))), vz);
+
+		__m256i d = _mm256_add_epi64(_mm256_mul_epi32(dx, dx),
+									 _mm256_add_epi64(_mm256_mul_epi32(dy, dy), _mm256_mul_epi32(dz, dz)));
+		_mm256_storeu_si256(reinterpret_cast<__m256i*>(out + i), d);
+	}
+#endif
+
+	for (; i < n; i++) {
+		int64_t dx = static_cast<int64_t>(xs[i]) - px;
+		int64_t dy = static_cast<int64_t>(ys[i]) - py;
+		int64_t dz = static_cast<int64_t>(zs[i]) - pz;
+		out[i] = static_cast<uint64_t>(dx * dx) + static_cast<uint64_t>(dy * dy) + static_cast<uint64_t>(dz * dz);
+	}
+}
+
+void point_cloud_t::sq_distances(const point3i_t& p, std::span<distance_t> out) const {
+	assert(out.size() >= size());
+
+	sq_distances_run(std::assume_aligned<64>(x.data()),
+					 std::assume_aligned<64>(y.data()),
+					 std::assume_aligned<64>(z.data()),
+					 size(), p.x, p.y, p.z, out.data());
+}
+
+void point_cloud_t::sq_distance_tile(size_t i0, size_t i1, size_t j0, size_t j1, std::span<distance_t> out) const {
+	assert(i0 <= i1 && i1 <= size() && j0 <= j1 && j1 <= size());
+	assert(out.size() >= (i1 - i0) * (j1 - j0));
+
+	size_t width = j1 - j0;
+	for (size_t i = i0; i < i1; i++) {
+		sq_distances_run(&x[j0], &y[j0], &z[j0], width, x[i], y[i], z[i], &out[(i - i0) * width]);
+	}
+}
+
+std::pair<point3i_t, point3i_t> point_cloud_t::bounding_box() const {
+	if (empty()) {
+		return {};
+	}
+
+	// one pass per axis; each is a plain min/max reduction the compiler vectorizes
+	auto axis = [n = size()](const coordinate_t* __restrict v) {
+		coordinate_t lo = std::numeric_limits<coordinate_t>::max();
+		coordinate_t hi = std::numeric_limits<coordinate_t>::min();
+		for (size_t i = 0; i < n; i++) {
+			lo = std::min(lo, v[i]);
+			hi = std::max(hi, v[i]);
+		}
+		return std::pair<coordinate_t, coordinate_t>{lo, hi};
+	};
+
+	auto [min_x, max_x] = axis(std::assume_aligned<64>(x.data()));
+	auto [min_y, max_y] = axis(std::assume_aligned<64>(y.data()));
+	auto [min_z, max_z] = axis(std::assume_aligned<64>(z.data()));
+
+	return {{min_x, min_y, min_z}, {max_x, max_y, max_z}};
+}
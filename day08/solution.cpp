@@ -17,18 +17,24 @@
 #include <vector>  		// collection
 #include <climits>
 #include <unordered_set>
-#include <map>
 
+#include "mapped_file.h"
 #include "point.h"
+#include "point_cloud.h"
+#include "point_parser.h"
+#include "radix_sort.h"
 
 using namespace std;
 
 /* Update with data type and result types */
-using data_t = vector<point_t *>;
+using data_t = point_cloud_t;
 using result_t = size_t;
 
-/* circuits are a set of point_t pointers */
-using circuit_t = unordered_set<point_t *>;
+/* junction boxes are known by their index in data */
+using junction_t = size_t;
+
+/* circuits are a set of junction boxes */
+using circuit_t = unordered_set<junction_t>;
 
 /* for pretty printing durations */
 using duration_t = chrono::duration<double, milli>;
@@ -37,26 +43,15 @@ using duration_t = chrono::duration<double, milli>;
 const data_t read_data(const string& filename) {
 	data_t data;
 
-	std::ifstream ifs(filename);
-
-	string line;
-	while (getline(ifs, line)) {
-		if (!line.empty()) {
-			point_t *p = new point_t(point_t::from_string(line));
-			data.push_back(p);
-		}
+	// one section, but a stray blank line shouldn't drop the rest of it
+	mapped_file_t file(filename);
+	for (string_view rest = file.view(); !rest.empty();) {
+		rest = parse_points(rest, data);
 	}
 
 	return data;
 }
 
-size_t sq_distance(const point_t* p1, const point_t* p2) {
-	auto x = (size_t)((p1->x - p2->x) * (p1->x - p2->x));
-	auto y = (size_t)((p1->y - p2->y) * (p1->y - p2->y));
-	auto z = (size_t)((p1->z - p2->z) * (p1->z - p2->z));	
-	return x + y + z;
-}
-
 /* Part 1 
 	729 too low
 */
@@ -74,21 +69,23 @@ size_t sq_distance(const point_t* p1, const point_t* p2) {
 
 */
 
-/* Return a map of the distance between all pairs of points
- * 	distance -> {point, point}
- * Assume no two pairs of points have the same distance
+/* Distance between a pair of points (junction boxes) */
+using connection_t = pair<size_t, pair<junction_t, junction_t>>;
+
+/* Return the distance between all pairs of points, shortest first
+ * 	{distance, {point, point}}
+ * Pairs the same distance apart stay in the order for_each_pair found them.
  */
-map<size_t, pair<point_t *, point_t *>> point_distances(const data_t &data) {
-	map<size_t, pair<point_t *, point_t *>> distance_map;
+vector<connection_t> point_distances(const data_t &data) {
+	vector<connection_t> distances;
+	distances.reserve(data.size() * (data.size() - 1) / 2);
 
-	for (size_t i = 0; i < data.size(); i++) {
-		for (size_t j = i + 1; j < data.size(); j++) {
-			auto distance = sq_distance(data[i], data[j]);
-			distance_map[distance] = {data[i], data[j]};
-		}
-	}
+	data.for_each_pair([&distances](size_t i, size_t j, size_t distance) {
+		distances.push_back({distance, {i, j}});
+	});
 
-	return distance_map;
+	radix_sort_by_first(distances);
+	return distances;
 }
 
 /* Return vector of circuit sizes, sorted largest to smallest. */
@@ -104,7 +101,7 @@ vector<result_t> circuit_sizes(unordered_set<circuit_t *> circuits) {
 
 /* Add one circuit to circuits for each point (junction box) in data set. */
 void add_circuits(const data_t& data, unordered_set<circuit_t *>& circuits) {
-	for (auto junction_box : data) {
+	for (junction_t junction_box = 0; junction_box < data.size(); junction_box++) {
 		circuit_t *circuit = new circuit_t();
 		circuit->insert(junction_box);
 		circuits.insert(circuit);
@@ -114,7 +111,7 @@ void add_circuits(const data_t& data, unordered_set<circuit_t *>& circuits) {
 /* Return the circuit that contains the point p, NULL otherwise.
  * Should never be null.
  */
-circuit_t *find_circuit(unordered_set<circuit_t *>& circuits, point_t *p) {
+circuit_t *find_circuit(unordered_set<circuit_t *>& circuits, junction_t p) {
 	for (circuit_t *c : circuits) {
 		if (c->contains(p)) {
 			return c;
@@ -129,7 +126,7 @@ circuit_t *find_circuit(unordered_set<circuit_t *>& circuits, point_t *p) {
  * Remove the circuit that p2 was in.
  * If they are in the same circuit, do nothing.
  */
-void merge_circuits(unordered_set<circuit_t *>& circuits, point_t *p1, point_t *p2) {
+void merge_circuits(unordered_set<circuit_t *>& circuits, junction_t p1, junction_t p2) {
 	circuit_t *c1 = find_circuit(circuits, p1);
 	circuit_t *c2 = find_circuit(circuits, p2);
 	if (c1 != c2) {
@@ -142,9 +139,9 @@ void merge_circuits(unordered_set<circuit_t *>& circuits, point_t *p1, point_t *
 }
 
 result_t part1(const data_t& data) {
-	// there should be 1,000 choose 2 = 499,500 pairs in this map
+	// there should be 1,000 choose 2 = 499,500 pairs
 	// for the input data (1,000 points)
-	auto distance_map = point_distances(data);
+	auto distances = point_distances(data);
 
 	unordered_set<circuit_t *> circuits;
 	add_circuits(data, circuits);
@@ -154,7 +151,7 @@ result_t part1(const data_t& data) {
 	 */
 	int connections = data.size() > 20 ? 1000 : 10;
 
-	for (const auto [distance, points] : distance_map | views::take(connections)) {
+	for (const auto& [distance, points] : distances | views::take(connections)) {
 		auto [p1, p2] = points;
 		merge_circuits(circuits, p1, p2);		
 	}
@@ -165,14 +162,14 @@ result_t part1(const data_t& data) {
 }
 
 result_t part2(const data_t& data) {
-	auto distance_map = point_distances(data);
+	auto distances = point_distances(data);
 
 	unordered_set<circuit_t *> circuits;
 	add_circuits(data, circuits);
 
-	point_t *p1 = NULL;
-	point_t *p2 = NULL;
-	for (const auto [distance, points] : distance_map) {
+	junction_t p1 = 0;
+	junction_t p2 = 0;
+	for (const auto& [distance, points] : distances) {
 		p1 = points.first;
 		p2 = points.second;
 		merge_circuits(circuits, p1, p2);	
@@ -182,7 +179,7 @@ result_t part2(const data_t& data) {
 		}
 	}
 
-	result_t result = (result_t)p1->x * (result_t)p2->x;
+	result_t result = (result_t)data.x[p1] * (result_t)data.x[p2];
 	return result;
 }
 
@@ -0,0 +1,35 @@
+#if !defined(HASH_H)
+#define HASH_H
+
+#include <cstddef>
+#include <cstdint>
+
+/* Hash helpers for the std::hash specializations and flat_hash tables.
+ *
+ * hash_mix() is the splitmix64 finalizer; every input bit affects every
+ * output bit, so the low bits are safe to mask for a power-of-two table even
+ * for small or negative coordinates.
+ */
+constexpr uint64_t hash_mix(uint64_t h) {
+	h ^= h >> 30;
+	h *= 0xbf58476d1ce4e5b9ull;
+	h ^= h >> 27;
+	h *= 0x94d049bb133111ebull;
+	h ^= h >> 31;
+	return h;
+}
+
+/* Fold another value into a running hash (order matters). */
+constexpr uint64_t hash_combine(uint64_t seed, uint64_t value) {
+	return hash_mix(seed + 0x9e3779b97f4a7c15ull + value);
+}
+
+/* Combine any number of integral values into one hash. */
+template <typename... Ts>
+constexpr size_t hash_values(Ts... values) {
+	uint64_t h = 0;
+	((h = hash_combine(h, static_cast<uint64_t>(values))), ...);
+	return static_cast<size_t>(h);
+}
+
+#endif
@@ -17,12 +17,16 @@
 #include <vector>  		// collection
 #include <map>
 
+#include "mapped_file.h"
 #include "point.h"
+#include "point_parser.h"
+#include "raster.h"
 
 using namespace std;
 
 /* Update with data type and result types */
-using data_t = vector<point_t>;
+using tile_t = point2i_t;
+using data_t = vector<tile_t>;
 using result_t = size_t;
 
 /* for pretty printing durations */
@@ -32,30 +36,27 @@ using duration_t = chrono::duration<double, milli>;
 const data_t read_data(const string& filename) {
 	data_t data;
 
-	std::ifstream ifs(filename);
-
-	string line;
-	while (getline(ifs, line)) {
-		if (!line.empty()) {
-			data.push_back(point_t::from_string(line));
-		}
+	// one section, but a stray blank line shouldn't drop the rest of it
+	mapped_file_t file(filename);
+	for (string_view rest = file.view(); !rest.empty();) {
+		rest = parse_points(rest, data);
 	}
 
 	return data;
 }
 
 struct rectangle_t {
-	point_t p1;
-	point_t p2;
+	tile_t p1;
+	tile_t p2;
 
-	rectangle_t(const point_t& a, const point_t& b) : p1(), p2() {
+	rectangle_t(const tile_t& a, const tile_t& b) : p1(), p2() {
 		p1.x = min(a.x, b.x);
 		p1.y = min(a.y, b.y);
 		p2.x = max(a.x, b.x);
 		p2.y = max(a.y, b.y);
 	}
 
-	rectangle_t(const tuple<point_t, point_t>& tp) : p1(), p2() {
+	rectangle_t(const tuple<tile_t, tile_t>& tp) : p1(), p2() {
 		p1.x = min(get<0>(tp).x, get<1>(tp).x);
 		p1.y = min(get<0>(tp).y, get<1>(tp).y);
 		p2.x = max(get<0>(tp).x, get<1>(tp).x);
@@ -63,12 +64,12 @@ struct rectangle_t {
 	}
 
 	dimension_t area() const {
-		auto x = (p1.x < p2.x) ? (p2.x - p1.x) : (p1.x - p2.x);
-		auto y = (p1.y < p2.y) ? (p2.y - p1.y) : (p1.y - p2.y);
+		dimension_t x = (p1.x < p2.x) ? (p2.x - p1.x) : (p1.x - p2.x);
+		dimension_t y = (p1.y < p2.y) ? (p2.y - p1.y) : (p1.y - p2.y);
 		return (x+1) * (y+1);
 	}
 
-	bool contains(const point_t& p) const {
+	bool contains(const tile_t& p) const {
 		return (p1.x < p.x && p.x < p2.x &&
 				p1.y < p.y && p.y < p2.y);
 	}
@@ -100,35 +101,11 @@ result_t part1(const data_t& data) {
 	return (result_t)ranges::max(areas);
 }
 
-/* Returns the midpoint of the line described by p1 and p2. */
-point_t midpoint(const point_t& p1, const point_t& p2) {
-	const auto p = p1 + p2;
-	return {p.x/2, p.y/2};
-}
-
-/* Returns true if the rectangle is inside the polygon described by
- * the vector of points. False otherwise.
+/* Returns true if every tile of the rectangle is red or green, on or
+ * inside the loop of red tiles. False otherwise.
  */
-bool enclosed_rectangle(const rectangle_t& r, const data_t& polygon) {
-	for (size_t i = 0; i < polygon.size(); i++) {
-		const point_t& p1 = polygon[i];
-
-		// check starting point of line
-		if (r.contains(p1)) {
-			return false;
-		}
-
-		// check mid-point of line
-		const point_t& p2 = polygon[(i+1) % polygon.size()];
-		const point_t p(midpoint(p1, p2));
-		if (r.contains(p)) {
-			return false;
-		}
-	}
-
-	// all points of polygon were outside the rectangle
-	// and no lines of the polygon intersected it
-	return true;
+bool enclosed_rectangle(const rectangle_t& r, const compressed_grid_t& polygon) {
+	return polygon.contains_box(r.p1, r.p2);
 }
 
 /* Part 2 */
@@ -145,10 +122,12 @@ result_t part2(const data_t& data) {
 	// 			return r.area(); 
 	// 		});
 
+	const auto polygon = compressed_grid_t::from_polygon(data);
+
 	const auto areas = views::cartesian_product(data, data)
 		| views::transform([](const auto& t) { return rectangle_t(t); })
-		| views::transform([&data](const rectangle_t& r) { 
-			return enclosed_rectangle(r, data) ? r.area() : 0; 
+		| views::transform([&polygon](const rectangle_t& r) { 
+			return enclosed_rectangle(r, polygon) ? r.area() : 0; 
 		});
 		
 	// Get the largest area rectangle
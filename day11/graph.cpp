@@ -0,0 +1,274 @@
+#include "graph.h"
+
+#include <algorithm>  // count, min
+
+graph_t graph_t::from_edges(size_t nodes, const std::vector<std::pair<node_t, node_t>>& edges) {
+	graph_t graph;
+
+	// counting sort by source; offsets[u + 1] counts u's edges, then is summed
+	graph.offsets.assign(nodes + 1, 0);
+	for (const auto& [from, to] : edges) {
+		graph.offsets[from + 1]++;
+	}
+	for (size_t u = 0; u < nodes; u++) {
+		graph.offsets[u + 1] += graph.offsets[u];
+	}
+
+	std::vector<uint32_t> next(graph.offsets.begin(), graph.offsets.end() - 1);
+	graph.targets.resize(edges.size());
+	for (const auto& [from, to] : edges) {
+		graph.targets[next[from]++] = to;
+	}
+
+	return graph;
+}
+
+node_t graph_t::id_of(std::string_view name) const {
+	auto it = _ids.find(name);
+	return it == _ids.end() ? no_node : it->second;
+}
+
+graph_t graph_t::reverse() const {
+	graph_t reversed;
+
+	// the same counting sort as from_edges, by target
+	reversed.offsets.assign(size() + 1, 0);
+	for (node_t v : targets) {
+		reversed.offsets[v + 1]++;
+	}
+	for (size_t v = 0; v < size(); v++) {
+		reversed.offsets[v + 1] += reversed.offsets[v];
+	}
+
+	std::vector<uint32_t> next(reversed.offsets.begin(), reversed.offsets.end() - 1);
+	reversed.targets.resize(targets.size());
+	for (node_t u = 0; u < size(); u++) {
+		for (node_t v : neighbors(u)) {
+			reversed.targets[next[v]++] = u;
+		}
+	}
+
+	reversed.names = names;
+	reversed._ids = _ids;
+	return reversed;
+}
+
+namespace {
+
+bool is_name_char(char c) {
+	return c != ' ' && c != '\t' && c != '\r' && c != '\n' && c != ':';
+}
+
+}  // namespace
+
+graph_t parse_graph(std::string_view text) {
+	// views into text while scanning; copied out once at the end
+	flat_hash_map<std::string_view, node_t> ids;
+	std::vector<std::string_view> names;
+	std::vector<std::pair<node_t, node_t>> edges;
+
+	// about one new name per line; growing the table is most of the cost
+	size_t lines = static_cast<size_t>(std::count(text.begin(), text.end(), '\n')) + 1;
+	ids.reserve(lines);
+	names.reserve(lines);
+	edges.reserve(lines * 2);
+
+	auto intern = [&](std::string_view name) {
+		auto [it, inserted] = ids.try_emplace(name, static_cast<node_t>(names.size()));
+		if (inserted) {
+			names.push_back(name);
+		}
+		return it->second;
+	};
+
+	size_t pos = 0;
+	while (pos < text.size()) {
+		size_t eol = text.find('\n', pos);
+		if (eol == std::string_view::npos) {
+			eol = text.size();
+		}
+
+		std::string_view line = text.substr(pos, eol - pos);
+		pos = eol + 1;
+
+		size_t colon = line.find(':');
+		if (colon == std::string_view::npos) {
+			continue;  // blank (or not an adjacency line)
+		}
+
+		size_t i = 0;
+		while (i < colon && !is_name_char(line[i])) {
+			i++;
+		}
+		size_t end = i;
+		while (end < colon && is_name_char(line[end])) {
+			end++;
+		}
+		node_t from = intern(line.substr(i, end - i));
+
+		i = colon + 1;
+		while (i < line.size()) {
+			while (i < line.size() && !is_name_char(line[i])) {
+				i++;
+			}
+			end = i;
+			while (end < line.size() && is_name_char(line[end])) {
+				end++;
+			}
+			if (end > i) {
+				edges.push_back({from, intern(line.substr(i, end - i))});
+			}
+			i = end;
+		}
+	}
+
+	graph_t graph = graph_t::from_edges(names.size(), edges);
+	graph.names.reserve(names.size());
+	graph._ids.reserve(names.size());
+	for (node_t u = 0; u < names.size(); u++) {
+		graph.names.emplace_back(names[u]);
+		graph._ids.try_emplace(graph.names.back(), u);
+	}
+
+	return graph;
+}
+
+std::vector<node_t> topological_order(const graph_t& graph) {
+	std::vector<uint32_t> in_degree(graph.size(), 0);
+	for (node_t v : graph.targets) {
+		in_degree[v]++;
+	}
+
+	// order doubles as the queue of nodes with nothing left pointing at them
+	std::vector<node_t> order;
+	order.reserve(graph.size());
+	for (node_t u = 0; u < graph.size(); u++) {
+		if (in_degree[u] == 0) {
+			order.push_back(u);
+		}
+	}
+
+	for (size_t next = 0; next < order.size(); next++) {
+		for (node_t v : graph.neighbors(order[next])) {
+			if (--in_degree[v] == 0) {
+				order.push_back(v);
+			}
+		}
+	}
+
+	return order;
+}
+
+std::optional<std::vector<node_t>> topological_order(const graph_t& graph, node_t start) {
+	// find what start reaches, counting in-degrees from those nodes only
+	std::vector<uint32_t> in_degree(graph.size(), 0);
+	std::vector<bool> reached(graph.size(), false);
+	std::vector<node_t> stack = {start};
+	reached[start] = true;
+	size_t reachable = 1;
+	while (!stack.empty()) {
+		const node_t u = stack.back();
+		stack.pop_back();
+		for (node_t v : graph.neighbors(u)) {
+			in_degree[v]++;
+			if (!reached[v]) {
+				reached[v] = true;
+				reachable++;
+				stack.push_back(v);
+			}
+		}
+	}
+
+	// then Kahn's algorithm from start; a reachable cycle is never freed
+	std::vector<node_t> order;
+	order.reserve(reachable);
+	if (in_degree[start] == 0) {
+		order.push_back(start);
+	}
+
+	for (size_t next = 0; next < order.size(); next++) {
+		for (node_t v : graph.neighbors(order[next])) {
+			if (--in_degree[v] == 0) {
+				order.push_back(v);
+			}
+		}
+	}
+
+	if (order.size() != reachable) {
+		return std::nullopt;
+	}
+	return order;
+}
+
+components_t strongly_connected_components(const graph_t& graph) {
+	constexpr uint32_t unvisited = UINT32_MAX;
+
+	components_t result;
+	result.component.assign(graph.size(), graph_t::no_node);
+
+	std::vector<uint32_t> index(graph.size(), unvisited);
+	std::vector<uint32_t> low(graph.size(), 0);
+	std::vector<node_t> open;	 // visited, not yet in a component
+	std::vector<std::pair<node_t, uint32_t>> calls;	 // (node, next edge), the recursion by hand
+	uint32_t visited = 0;
+
+	auto visit = [&](node_t u) {
+		index[u] = low[u] = visited++;
+		open.push_back(u);
+		calls.push_back({u, graph.offsets[u]});
+	};
+
+	for (node_t root = 0; root < graph.size(); root++) {
+		if (index[root] != unvisited) {
+			continue;
+		}
+
+		visit(root);
+		while (!calls.empty()) {
+			const node_t u = calls.back().first;
+			uint32_t& edge = calls.back().second;
+
+			if (edge < graph.offsets[u + 1]) {
+				const node_t v = graph.targets[edge++];
+				if (index[v] == unvisited) {
+					visit(v);  // edge is stale after this
+				} else if (result.component[v] == graph_t::no_node) {
+					low[u] = std::min(low[u], index[v]);
+				}
+				continue;
+			}
+
+			// every edge out of u is done; u roots a component if nothing reached above it
+			if (low[u] == index[u]) {
+				const auto id = static_cast<node_t>(result.count++);
+				node_t v;
+				do {
+					v = open.back();
+					open.pop_back();
+					result.component[v] = id;
+				} while (v != u);
+			}
+
+			calls.pop_back();
+			if (!calls.empty()) {
+				const node_t parent = calls.back().first;
+				low[parent] = std::min(low[parent], low[u]);
+			}
+		}
+	}
+
+	return result;
+}
+
+graph_t condense(const graph_t& graph, const components_t& components) {
+	std::vector<std::pair<node_t, node_t>> edges;
+	for (node_t u = 0; u < graph.size(); u++) {
+		for (node_t v : graph.neighbors(u)) {
+			if (components.component[u] != components.component[v]) {
+				edges.push_back({components.component[u], components.component[v]});
+			}
+		}
+	}
+
+	return graph_t::from_edges(components.count, edges);
+}
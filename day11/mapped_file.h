@@ -0,0 +1,38 @@
+#if !defined(MAPPED_FILE_H)
+#define MAPPED_FILE_H
+
+#include <cstddef>
+#include <string>
+#include <string_view>
+
+/* Read-only view of a whole file, memory mapped so parsing can run straight
+ * over the page cache with no copies and no getline.
+ *
+ *	mapped_file_t file(filename);
+ *	std::string_view text = file.view();
+ *
+ * If the file cannot be opened the view is empty (and is_open() is false),
+ * like reading from a bad ifstream. The view is only good while the
+ * mapped_file_t is alive.
+ */
+class mapped_file_t {
+   public:
+	explicit mapped_file_t(const std::string& file_name);
+	~mapped_file_t();
+
+	mapped_file_t(const mapped_file_t&) = delete;
+	mapped_file_t& operator=(const mapped_file_t&) = delete;
+
+	bool is_open() const { return _open; }
+	size_t size() const { return _size; }
+	std::string_view view() const { return {_data, _size}; }
+
+   private:
+	const char* _data = nullptr;
+	size_t _size = 0;
+	bool _open = false;
+	bool _mapped = false;
+	std::string _contents = {};	 // when mmap is not possible (pipes, empty files)
+};
+
+#endif
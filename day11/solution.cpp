@@ -11,36 +11,19 @@
 #include <cstring>	  	// strtok, strdup
 #include <fstream>	  	// ifstream (reading file)
 #include <numeric>	  	// max, reduce, etc.
+#include <optional>
 #include <print>		// formatted print
 #include <ranges>  		// ranges and views
 #include <string>  		// strings
 #include <vector>  		// collection
-#include <map>
 
-#include "split.h"	// split strings
+#include "graph.h"		  // graph_t, parse_graph, topological_order, fold_dag
+#include "mapped_file.h"  // mapped_file_t
 
 using namespace std;
 
-template <>
-struct std::formatter<vector<string>> {
-	constexpr auto parse(std::format_parse_context& context) {
-		return context.begin();
-	}
-
-	auto format(const vector<string>& vec, std::format_context& context) const {
-		auto out = context.out();
-
-		for (size_t i = 0; i < vec.size(); i++) {
-			auto sep = (i < vec.size()-1) ? ", " : "";
-			std::format_to(out, "{}{}", vec[i], sep);
-		}
-
-		return out;
-	}
-};
-
 /* Update with data type and result types */
-using data_t = std::map<string, vector<string>>;
+using data_t = graph_t;
 using result_t = size_t;
 
 /* for pretty printing durations */
@@ -48,91 +31,68 @@ using duration_t = chrono::duration<double, milli>;
 
 /* Read the data file... */
 const data_t read_data(const string& filename) {
-	data_t data;
-
-	std::ifstream ifs(filename);
-
-	string line;
-	while (getline(ifs, line)) {
-		if (!line.empty()) {
-			auto kv = split(line, ":");
-			auto values = split(kv[1]);
-
-			data[kv[0]] = values;
-		}
-	}
-
-	return data;
+	mapped_file_t file(filename);
+	return parse_graph(file.view());
 }
 
-/* Return the number of paths to get from `start` to `end` */
-// result_t count_paths(const data_t& network, const string& start, const string& end) {
-// 	if (start == end) {
-// 		return 1;
-// 	}
-
-// 	result_t paths = 0;
-// 	for (const auto& next : network.at(start)) {
-// 		paths += count_paths(network, next, end);
-// 	}
-
-// 	return paths;
-// }
-
-std::map<string, size_t> cache;
-
-/* Return the number of paths to get from `start` to `end` */
-result_t count_paths(const data_t& network, const string& start, const string& end) {
-	string key = start + end;
-	if (cache.contains(key)) {
-		return cache.at(key);
+/* Nodes reachable from `start` in topological order; paths can only be
+ * counted if no cycle can be reached from there */
+vector<node_t> path_order(const data_t& network, node_t start) {
+	optional<vector<node_t>> order = topological_order(network, start);
+	if (!order) {
+		std::print(stderr, "ERROR: The network has a cycle reachable from {}\n", network.name_of(start));
+		exit(3);
 	}
 
-	if (start == end) {
-		return 1;
-	}
+	return *order;
+}
 
-	if (!network.contains(start)) {
-		return 0;
+/* Return the number of paths from `start` (by name) to every node, in one
+ * sweep down the topological order; all zero if there is no such node */
+vector<result_t> count_paths(const data_t& network, const string& start) {
+	vector<result_t> paths(network.size(), 0);
+	node_t source = network.id_of(start);
+	if (source == graph_t::no_node) {
+		return paths;
 	}
 
-	result_t paths = 0;
-	for (const auto& next : network.at(start)) {
-		paths += count_paths(network, next, end);
-	}
+	paths[source] = 1;
+	return fold_dag(network, path_order(network, source), std::move(paths),
+					[](result_t& to, result_t from, node_t, node_t) { to += from; });
+}
 
-	cache[key] = paths;
-	return paths;
+/* The entry of `paths` for node `name`, 0 if there is no such node */
+result_t paths_to(const data_t& network, const vector<result_t>& paths, const string& name) {
+	node_t to = network.id_of(name);
+	return to == graph_t::no_node ? 0 : paths[to];
 }
 
 /* Part 1 */
 result_t part1(const data_t& data) {
-	cache.clear();
-
 	// this works for input data
-	if (data.contains("you")) {
-		return count_paths(data, "you", "out");
-	}
-
-	return count_paths(data, "svr", "out");
+	const string start = data.id_of("you") != graph_t::no_node ? "you" : "svr";
+	return paths_to(data, count_paths(data, start), "out");
 }
 
 result_t part2(const data_t& data) {
-	cache.clear();
+	if (data.id_of("svr") != graph_t::no_node) {
+		// one sweep from each start, every target read off it
+		const vector<result_t> from_svr = count_paths(data, "svr");
+		const vector<result_t> from_dac = count_paths(data, "dac");
+		const vector<result_t> from_fft = count_paths(data, "fft");
 
-	if (data.contains("svr")) {
-		result_t to_dac = count_paths(data, "svr", "dac")
-						* count_paths(data, "dac", "fft")
-						* count_paths(data, "fft", "out");
+		result_t to_dac = paths_to(data, from_svr, "dac")
+						* paths_to(data, from_dac, "fft")
+						* paths_to(data, from_fft, "out");
 
-		result_t to_fft = count_paths(data, "svr", "fft")
-						* count_paths(data, "fft", "dac")
-						* count_paths(data, "dac", "out");
+		result_t to_fft = paths_to(data, from_svr, "fft")
+						* paths_to(data, from_fft, "dac")
+						* paths_to(data, from_dac, "out");
 
 		return to_dac + to_fft;
 	}
 
-	return count_paths(data, "you", "out");
+	return paths_to(data, count_paths(data, "you"), "out");
 }
 
 int main(int argc, char* argv[]) {